@@ -18,7 +18,7 @@ SymbolTable::SymbolTable () :
     tableIndex()
 {
     // Add the NULL Symbol
-    table.add (SymbolTableEntry ("", 0));
+    table.add (new SymbolTableEntry ("", 0));
     tableIndex.set ("", 0);
 }
 
@@ -30,11 +30,10 @@ SymbolTable::~SymbolTable ()
 
 bool SymbolTable::contains (SymbolID unique) const
 {
-    for (auto& each : table)
-        if (each.unique == unique)
-            return true;
+    ScopedLock sl (lock);
     
-    return false;
+    // Entries are stored at the position of their unique ID
+    return isPositiveAndBelow (unique, table.size());
 }
 
 SymbolTableEntry& SymbolTable::lookup (SymbolID unique) const
@@ -46,7 +45,7 @@ SymbolTableEntry& SymbolTable::lookup (SymbolID unique) const
         print();
         jassertfalse;
     }
-    return table.getReference(unique);
+    return *table.getUnchecked (unique);
 }
 
 SymbolID SymbolTable::lookupOrCreateEntry (const String& name, bool incrementRefs)
@@ -64,10 +63,18 @@ SymbolID SymbolTable::lookupOrCreateEntry (const String& name, bool incrementRef
         return unique;
     }
     
-    SymbolTableEntry entry (name, table.size());
-    table.add (entry);
-    tableIndex.set (name, entry.unique);
-    return entry.unique;
+    auto entry = table.add (new SymbolTableEntry (name, table.size()));
+    tableIndex.set (name, entry->unique);
+    return entry->unique;
+}
+
+SymbolID SymbolTable::lookupEntry (const String& name) const
+{
+    if (name.isEmpty())
+        return 0;
+    
+    ScopedLock sl (lock);
+    return tableIndex[name];
 }
 
 int SymbolTable::incrementReferences (SymbolID unique)
@@ -102,9 +109,9 @@ void SymbolTable::print() const
     DBG ("SymbolTable (" << table.size() << ")");
     for (auto entry : table)
     {
-        DBG (entry.print());
+        DBG (entry->print());
         // Quick hack integrity test
-        jassert (entry.unique == tableIndex[entry.name]);
+        jassert (entry->unique == tableIndex[entry->name]);
     }
 }
 
@@ -167,6 +174,16 @@ bool Symbol::isValidIdentifier (const String& possibleIdentifier) noexcept
         && possibleIdentifier.containsOnly ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:#@$%");
 }
 
+SymbolID Symbol::intern (const String& name)
+{
+    return SymbolTable::instance().lookupOrCreateEntry (name, false);
+}
+
+SymbolID Symbol::find (const String& name)
+{
+    return SymbolTable::instance().lookupEntry (name);
+}
+
 SymbolTableEntry& Symbol::lookup () const
 {
     return SymbolTable::instance().lookup (unique);
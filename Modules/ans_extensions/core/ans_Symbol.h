@@ -94,7 +94,11 @@ public:
 
 friend class Symbol;
 protected:
-    /** Lookup a SymbolTableEntry by unique SymbolID */
+    /**
+     Lookup a SymbolTableEntry by unique SymbolID. Entries are allocated individually and never
+     move or get deleted while the table exists, so the reference stays valid after the lock is
+     released, even if other threads add entries meanwhile.
+     */
     SymbolTableEntry& lookup (SymbolID unique) const;
     
     bool contains (SymbolID unique) const;
@@ -102,6 +106,9 @@ protected:
     /** Add a new entry and assign it a unique SymbolID */
     SymbolID lookupOrCreateEntry (const String& literal, bool incrementReferences = true);
     
+    /** Return the unique SymbolID of an existing entry, or 0 if there is none */
+    SymbolID lookupEntry (const String& literal) const;
+    
     int incrementReferences (SymbolID unique);
     int decrementReferences (SymbolID unique);
     
@@ -109,7 +116,7 @@ protected:
 
 private:
     CriticalSection          lock;
-    Array<SymbolTableEntry>  table;
+    OwnedArray<SymbolTableEntry> table;
     HashMap<String,SymbolID> tableIndex;
 };
     
@@ -214,6 +221,20 @@ public:
     */
     static bool isValidIdentifier (const String& possibleIdentifier) noexcept;
     
+    /**
+     Return the unique SymbolID for any non-empty name, creating a table entry if necessary.
+     Unlike the constructors, this neither requires a valid identifier nor holds a reference,
+     which is fine since entries are never deleted. Returns 0 for an empty name.
+     */
+    static SymbolID intern (const String& name);
+    
+    /**
+     Return the unique SymbolID for a name, but only if a Symbol of that name exists already, or
+     else 0. Use this for lookups by name, which shouldn't grow the SymbolTable with names that
+     nothing can be registered under.
+     */
+    static SymbolID find (const String& name);
+    
     JUCE_LEAK_DETECTOR (Symbol)
     
 private:
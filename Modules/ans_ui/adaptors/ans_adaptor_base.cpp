@@ -20,8 +20,35 @@ namespace ans {
 #pragma mark UIAdaptor
 #endif
     
+    namespace
+    {
+        UIAdaptor::UpdateStatistics updateStats;
+    }
+    
+    /** Watches a culled adaptor's component and all its parents, until the component is on screen */
+    struct UIAdaptor::VisibilityWatcher : public ComponentMovementWatcher
+    {
+        VisibilityWatcher (UIAdaptor* a, Component* comp) :
+            ComponentMovementWatcher (comp),
+            adaptor (a)
+        {}
+        
+        void componentMovedOrResized (bool wasMoved, bool wasResized) override { check(); }
+        void componentPeerChanged() override { check(); }
+        void componentVisibilityChanged() override { check(); }
+        
+        void check()
+        {
+            if (adaptor != nullptr)
+                adaptor->replayIfOnScreen();
+        }
+        
+        UIAdaptor* adaptor; // nullptr once the watcher is about to be deleted
+    };
+    
     UIAdaptor::UIAdaptor (std::shared_ptr<UIInstance> instance, const ComponentSpec& spec) :
         identifier (spec.identifier),
+        key (spec.key),
         type (spec.type),
         ui (instance),
         insideUpdate (false),
@@ -37,6 +64,9 @@ namespace ans {
     {
         jassert (!insideBuild);
         
+        if (auto monitor = RenderCache::Monitor::getInstanceWithoutCreating())
+            monitor->unwatch (this);
+        
         if (ui != nullptr)
             ui->unregisterAdaptor (this);
     }
@@ -75,6 +105,9 @@ namespace ans {
                 addBinding (b->instantiateFor (getModel()));
         
         spec.layout.applyToComponent (comp);
+        
+        if (spec.renderCache != RenderCache::Policy::Never)
+            setRenderCache (spec.renderCache);
     }    
     
     void UIAdaptor::addComponent (std::unique_ptr<Component> comp)
@@ -112,10 +145,29 @@ namespace ans {
             DBG ("      " << getComponent()->getComponentID().quoted() << " performs " << binding->purpose.name);
 #endif
             binding->performFor(*this);
+            
+            // Back to painting directly while things are changing
+            if (renderCachePolicy == RenderCache::Policy::Auto)
+            {
+                enableRenderCache (false);
+                RenderCache::Monitor::getInstance()->watch (this);
+            }
         }
     }
     
     void UIAdaptor::update (Model* sender, Aspect aspect, void* argument)
+    {
+        if (ANS_CULL_HIDDEN_UPDATES && ! insideUpdate && ! isOnScreen())
+        {
+            cullUpdate (aspect);
+            return;
+        }
+        
+        updateStats.performed++;
+        performUpdate (aspect, UpdateScope::All);
+    }
+    
+    void UIAdaptor::performUpdate (Aspect aspect, UpdateScope scope)
     {
         // Prevents infinite loop in response to whatever this update triggers
         if (insideUpdate)
@@ -126,6 +178,9 @@ namespace ans {
         for (auto binding : bindings)
             if (binding != nullptr && binding->isAspected())
             {
+                if (scope != UpdateScope::All && mustNotCull (binding->purpose) != (scope == UpdateScope::NotCullable))
+                    continue;
+                
                 if (aspect == Model::Undefined)
                 {
                     // Undefined serves as a wildcard for selected purposes
@@ -141,6 +196,171 @@ namespace ans {
         insideUpdate = false;
     }
     
+    void UIAdaptor::cullUpdate (Aspect aspect)
+    {
+        updateStats.culled++;
+        pendingAspects.addIfNotAlreadyThere (aspect);
+        
+        // The component may be hidden by its own binding, which must not wait for it to show up,
+        // and some adaptors must let go of model contents right away (@see mustNotCull)
+        performUpdate (aspect, UpdateScope::NotCullable);
+        
+        if (visibilityWatcher == nullptr)
+            visibilityWatcher = std::make_unique<VisibilityWatcher> (this, getComponent());
+        
+        replayIfOnScreen();
+    }
+    
+    void UIAdaptor::replayIfOnScreen ()
+    {
+        if (pendingAspects.isEmpty() || ! isOnScreen())
+            return;
+        
+        stopWatchingVisibility();
+        
+        Array<Aspect> aspects;
+        aspects.swapWith (pendingAspects);
+        
+        // Each aspect once, no matter how often it was broadcast meanwhile. Bindings that must not
+        // be culled were performed by cullUpdate() already.
+        for (auto aspect : aspects)
+            performUpdate (aspect, UpdateScope::Cullable);
+        
+        updateStats.replayed += aspects.size();
+    }
+    
+    void UIAdaptor::stopWatchingVisibility ()
+    {
+        if (visibilityWatcher == nullptr)
+            return;
+        
+        // We may be called back by the watcher, so it mustn't be deleted right here
+        visibilityWatcher->adaptor = nullptr;
+        auto watcher = visibilityWatcher.release();
+        MessageManager::callAsync ([watcher] { delete watcher; });
+    }
+    
+    bool UIAdaptor::isOnScreen ()
+    {
+        auto comp = getComponent();
+        
+        // Unlike isShowing(), a minimised window still counts as on screen, since nothing would
+        // tell the watcher when it is restored
+        if (comp == nullptr || ! comp->isVisible())
+            return false;
+        
+        // Hidden or clipped away by a parent, e.g. scrolled out of a Viewport?
+        auto area = comp->getLocalBounds();
+        
+        while (auto parent = comp->getParentComponent())
+        {
+            if (! parent->isVisible())
+                return false;
+            
+            area = parent->getLocalArea (comp, area).getIntersection (parent->getLocalBounds());
+            if (area.isEmpty())
+                return false;
+            comp = parent;
+        }
+        return comp->isOnDesktop() && ! area.isEmpty();
+    }
+    
+    const UIAdaptor::UpdateStatistics& UIAdaptor::getUpdateStatistics ()
+    {
+        return updateStats;
+    }
+    
+    String UIAdaptor::UpdateStatistics::toString () const
+    {
+        String out;
+        out << "Adaptor updates performed: " << performed
+            << ", culled: " << culled
+            << ", replayed: " << replayed;
+        return out;
+    }
+    
+    void UIAdaptor::synchronise()
+    {
+        if (insideUpdate)
+            return;
+        
+        insideUpdate = true;
+        
+        // Purposes are ordered, so enablement/visibility come first and values before selections
+        for (auto binding : bindings)
+            if (binding != nullptr && binding->isAspected())
+                if (binding->purpose.respondToUndefined || binding->getAspect() != Model::Undefined)
+                    performBindingIfSet (binding);
+        
+        insideUpdate = false;
+    }
+    
+    void UIAdaptor::suspendBindings()
+    {
+        if (suspended || ui == nullptr)
+            return;
+        
+        ui->unregisterAdaptor (this);
+        suspended = true;
+    }
+    
+    void UIAdaptor::resumeBindings()
+    {
+        if (! suspended)
+            return;
+        
+        suspended = false;
+        ui->registerAdaptor (this);
+        synchronise();
+    }
+    
+    void UIAdaptor::setRenderCache (RenderCache::Policy policy)
+    {
+        renderCachePolicy = policy;
+        
+        if (policy == RenderCache::Policy::Auto)
+        {
+            // Start out painting directly, until the bindings have settled
+            enableRenderCache (false);
+            RenderCache::Monitor::getInstance()->watch (this);
+            return;
+        }
+        
+        if (auto monitor = RenderCache::Monitor::getInstanceWithoutCreating())
+            monitor->unwatch (this);
+        
+        enableRenderCache (policy == RenderCache::Policy::Always);
+    }
+    
+    void UIAdaptor::renderCacheIdle()
+    {
+        if (renderCachePolicy == RenderCache::Policy::Auto)
+            enableRenderCache (true);
+    }
+    
+    void UIAdaptor::enableRenderCache (bool on)
+    {
+        if (renderCacheEnabled == on)
+            return;
+        
+        auto comp = getComponent();
+        if (comp == nullptr)
+            return;
+        
+        renderCacheEnabled = on;
+        
+        if (on)
+        {
+            comp->setCachedComponentImage (new RenderCache (*comp, renderCacheStats));
+            renderCacheStats.enabled++;
+        }
+        else
+        {
+            comp->setCachedComponentImage (nullptr);
+            renderCacheStats.disabled++;
+        }
+    }
+    
     void UIAdaptor::warn (const Binding::Purpose& p)
     {
         DBG ("Binding for component " << getComponent()->getComponentID().quoted() << " in " << getModel()->getClass()->getName() <<
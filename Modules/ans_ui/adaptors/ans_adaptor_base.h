@@ -12,6 +12,7 @@
 #include "../core/ans_Binding.h"
 #include "../core/ans_Selection.h"
 #include "../specs/ans_ComponentSpec.h"
+#include "../utility/ans_RepaintBatcher.h"
 
 namespace ans {
     using namespace juce;
@@ -28,9 +29,13 @@ class TabPageList;
  channel with UIModel. UIAdaptor implements a uniform communication protocol that translates
  to and from an individual Juce Component's API. Since UIAdaptor is tied to a Component and
  vice versa (sister classes), ultimate ownership of a UIAdaptor is with the Component.
+ Components built by UIBuilder therefore come from the arena of their UIInstance (@see UIArena).
  */
 
-class UIAdaptor : public Dependent
+class UIAdaptor :
+        public Dependent,
+        public UIArena::Allocated,
+        private RenderCache::Client
 {
 public:
     
@@ -188,6 +193,12 @@ public:
     /** Access the Component branch of the multi-inherited instance */
     Component* getComponent() { return dynamic_cast<Component*>(this); }
     
+    /**
+     Have the component repainted at the end of the frame, merged with whatever else needs repainting.
+     Use this rather than Component::repaint() in response to the model (@see RepaintBatcher).
+     */
+    void repaintComponent() { RepaintBatcher::getInstance()->add (*getComponent()); }
+    
     /**
      Add a child component bounded by a given LayoutFrame. The adaptor takes ownership of it.
      Only composite adaptors support this, for others this issues a warning!
@@ -217,9 +228,57 @@ public:
 
     //--------------------------------------------------------------------------------------------
     
+    /**
+     Perform the bindings that respond to the aspect. If the component isn't on screen, i.e. it's hidden
+     or clipped away by a parent (e.g. scrolled out of a Viewport), only visibility bindings are performed
+     and the aspect is remembered. The bindings for all remembered aspects are performed once as soon as
+     the component shows up again.
+     */
     void update (Model* sender, Aspect aspect, void* argument) override;
     
+    /** Counters shared by all adaptors, for judging how many updates were culled */
+    struct UpdateStatistics
+    {
+        int performed = 0;      ///< Updates that performed bindings right away
+        int culled = 0;         ///< Updates that were remembered, since the component wasn't on screen
+        int replayed = 0;       ///< Remembered aspects that were performed once the component showed up
+        
+        String toString() const;
+    };
+    
+    static const UpdateStatistics& getUpdateStatistics();
+    
+    /** Whether the component is showing (in a window that may be minimised) and not entirely clipped away by its parents */
+    bool isOnScreen();
+    
+    /**
+     Perform every binding that would respond to an initial broadcast exactly once, i.e. all
+     aspected bindings that either have an aspect or respond to Model::Undefined. This is used
+     by UIInstance::synchronise() to bring a freshly built adaptor up to date.
+     */
+    void synchronise();
+    
+    /**
+     Stop responding to the model while the component is detached, but kept for reuse (@see UIVirtualForm).
+     The adaptor is removed from its UIInstance as well, so it can't be looked up by identifier meanwhile.
+     */
+    void suspendBindings();
+    
+    /** Undo suspendBindings() and bring the component up to date, since it missed all updates in between */
+    void resumeBindings();
+    
+    bool isSuspended() const { return suspended; }
+    
+    /** Change how the component's rendering is cached, which is usually taken from the spec */
+    void setRenderCache (RenderCache::Policy policy);
+    
+    RenderCache::Policy getRenderCachePolicy() const { return renderCachePolicy; }
+    
+    /** Hit/miss counters of the component's render cache, across all the times it was switched on */
+    const RenderCache::Statistics& getRenderCacheStatistics() const { return renderCacheStats; }
+    
     const ComponentID identifier;
+    const SymbolID key;
 
 friend class UIModel;
 friend class UIInstance;
@@ -228,7 +287,23 @@ protected:
     
     void initialiseFromSpec (std::shared_ptr<UIInstance> instance, const ComponentSpec& spec);
     void performBindingIfSet (Binding* binding);
+    /** Which of the bindings responding to an update are performed (@see mustNotCull) */
+    enum class UpdateScope { All, NotCullable, Cullable };
+    
+    void performUpdate (Aspect aspect, UpdateScope scope);
+    void cullUpdate (Aspect aspect);
+    
+    /**
+     Whether bindings of a purpose must be performed even while the component is not on screen.
+     This is always the case for GetVisible, and for adaptors that keep raw pointers to what the
+     model handed them, which must never be left pointing at something the model has deleted.
+     */
+    virtual bool mustNotCull (const Binding::Purpose& p) const { return p == Binding::Purpose::GetVisible; }
+    void replayIfOnScreen ();
+    void stopWatchingVisibility ();
     void warn (const Binding::Purpose& p);
+    void renderCacheIdle() override;
+    void enableRenderCache (bool on);
 
     UIComponentClass::Type type;
     std::shared_ptr<UIInstance> ui;
@@ -237,6 +312,14 @@ protected:
     Array<std::unique_ptr<Component>> ownedComponents;
     bool insideUpdate;
     bool insideBuild;
+    bool suspended = false;
+    bool renderCacheEnabled = false;
+    RenderCache::Policy renderCachePolicy = RenderCache::Policy::Never;
+    RenderCache::Statistics renderCacheStats;
+    Array<Aspect> pendingAspects;
+    
+    struct VisibilityWatcher;
+    std::unique_ptr<VisibilityWatcher> visibilityWatcher;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UIAdaptor)
 };
@@ -11,6 +11,7 @@
 
 #include "../specs/ans_UIComponentClass.h"
 #include "../utility/ans_Positioners.h"
+#include "../utility/ans_LayoutScheduler.h"
 
 namespace ans {
     using namespace juce;
@@ -44,11 +45,24 @@ void UIComposite::deleteContents()
 
 void UIComposite::resized()
 {
-    if (auto parent = getParentComponent())
-    {
-        if (auto positioner = getPositioner())
-            positioner->applyNewBounds (parent->getBounds());
-    }
+    // Inside a pass, the positioner that resized us is laying out our children anyway
+    if (LayoutScheduler::isInsidePass())
+        return;
+    
+    LayoutScheduler::getInstance()->markDirty (*this);
+}
+
+void UIComposite::childrenChanged()
+{
+    LayoutScheduler::childrenChanged (*this);
+}
+
+AnchorSolver* UIComposite::getAnchorSolver (bool create)
+{
+    if (anchorSolver == nullptr && create)
+        anchorSolver = std::make_unique<AnchorSolver> (*this);
+    
+    return anchorSolver.get();
 }
 
 void UIComposite::paint (Graphics& g)
@@ -74,7 +88,9 @@ void UIComposite::componentBuildBegin ()
 
 void UIComposite::componentBuildEnd ()
 {
+    // Lay out right away, so the new children never show at their default bounds
     resized();
+    LayoutScheduler::getInstance()->flush();
     sendLookAndFeelChange();
     setVisible (true);
     toFront (true);
@@ -82,4 +98,226 @@ void UIComposite::componentBuildEnd ()
 }
 
 
+//==========================================================================================================
+#if 0
+#pragma mark UIVirtualForm
+#endif
+
+UIVirtualForm::UIVirtualForm (std::shared_ptr<UIInstance> instance, const VirtualFormSpec& spec) :
+    Viewport (spec.identifier),
+    UIAdaptor (instance, spec),
+    content (instance, spec.identifier + "Content"),
+    overscan (spec.overscan),
+    cacheSize (spec.cacheSize)
+{
+    initialiseFromSpec (instance, spec);
+    
+    if (spec.hasBackgroundColour())
+        content.setBackgroundColour (spec.backgroundColour.colour);
+    
+    setViewedComponent (&content, false);
+    setScrollBarsShown (true, false);
+    
+    Array<const ComponentSpec*> others;
+    
+    for (auto child : spec.children)
+    {
+        if (child->layout.type == LayoutSpec::Frame && child->layout.frame.hasConstantVerticalExtent())
+            addRowSpec (child);
+        else
+            others.add (child);
+    }
+    
+    // LayoutCursor streams rows top-down anyway, but specs may have been edited
+    std::stable_sort (rows.begin(), rows.end(), [] (const Row* a, const Row* b)
+    {
+        return a->extent.getStart() < b->extent.getStart();
+    });
+    
+    for (auto row : rows)
+    {
+        contentHeight = jmax (contentHeight, row->extent.getEnd());
+        reach.add (contentHeight);
+    }
+    
+    for (auto child : others)
+        if (auto comp = UIBuilder::buildComponent (child, instance, &content))
+            pinned.add (comp.release());
+}
+
+UIVirtualForm::~UIVirtualForm ()
+{
+    // Rows and pinned children are deleted before the content they live in
+    cache.clear();
+    rows.clear();
+    pinned.clear();
+    setViewedComponent (nullptr, false);
+}
+
+void UIVirtualForm::addRowSpec (const ComponentSpec* spec)
+{
+    const auto extent = spec->layout.frame.getConstantVerticalExtent();
+    
+    // Cells of the same row are streamed one after the other
+    if (auto last = rows.getLast())
+        if (last->extent == extent)
+        {
+            last->specs.add (spec);
+            return;
+        }
+    
+    auto row = rows.add (new Row());
+    row->extent = extent;
+    row->specs.add (spec);
+}
+
+void UIVirtualForm::resized()
+{
+    Viewport::resized();
+    
+    const int width = getMaximumVisibleWidth();
+    
+    if (content.getWidth() != width || content.getHeight() != contentHeight)
+    {
+        content.setSize (width, contentHeight);
+        layoutContent();
+    }
+    updateLiveRows();
+}
+
+void UIVirtualForm::visibleAreaChanged (const juce::Rectangle<int>& newVisibleArea)
+{
+    updateLiveRows();
+}
+
+Range<int> UIVirtualForm::getRowsIntersecting (Range<int> area) const
+{
+    // The first row reaching into the area, up to the first row starting below it
+    const int first = (int) (std::upper_bound (reach.begin(), reach.end(), area.getStart()) - reach.begin());
+    
+    const auto below = std::lower_bound (rows.begin(), rows.end(), area.getEnd(), [] (const Row* row, int y)
+    {
+        return row->extent.getStart() < y;
+    });
+    const int last = (int) (below - rows.begin());
+    
+    return Range<int> (first, jmax (first, last));
+}
+
+void UIVirtualForm::updateLiveRows()
+{
+    Range<int> wanted;
+    
+    if (getHeight() > 0)
+    {
+        const auto view = getViewArea();
+        wanted = getRowsIntersecting (Range<int> (view.getY() - overscan, view.getBottom() + overscan));
+    }
+    
+    if (wanted == liveRows)
+        return;
+    
+    // Detach first, so the cache has the rows that just left, should we need to delete some
+    for (int i = liveRows.getStart(); i < liveRows.getEnd(); ++i)
+        if (! wanted.contains (i))
+            detachRow (*rows[i]);
+    
+    for (int i = wanted.getStart(); i < wanted.getEnd(); ++i)
+        if (! rows[i]->live)
+            attachRow (*rows[i]);
+    
+    liveRows = wanted;
+}
+
+void UIVirtualForm::attachRow (Row& row)
+{
+    if (row.components.isEmpty())
+    {
+        {
+            // Rows come and go while scrolling, an arena would never give their memory back
+            UIArena::Scope heap (nullptr);
+            
+            for (auto spec : row.specs)
+                if (auto comp = UIBuilder::buildComponent (spec, ui, &content))
+                    row.components.add (comp.release());
+        }
+        // UIInstance::synchronise() is long past for rows built while scrolling
+        for (auto comp : row.components)
+            forEachAdaptor (*comp, [] (UIAdaptor& adaptor) { adaptor.synchronise(); });
+        
+        stats.rowsBuilt++;
+    }
+    else
+    {
+        cache.removeFirstMatchingValue (&row);
+        
+        for (auto comp : row.components)
+        {
+            content.addAndMakeVisible (comp);
+            forEachAdaptor (*comp, [] (UIAdaptor& adaptor) { adaptor.resumeBindings(); });
+        }
+        stats.rowsReused++;
+    }
+    
+    row.live = true;
+    
+    for (auto comp : row.components)
+        layout (*comp);
+}
+
+void UIVirtualForm::detachRow (Row& row)
+{
+    for (auto comp : row.components)
+    {
+        forEachAdaptor (*comp, [] (UIAdaptor& adaptor) { adaptor.suspendBindings(); });
+        content.removeChildComponent (comp);
+    }
+    
+    row.live = false;
+    cache.add (&row);
+    
+    while (cache.size() > cacheSize)
+    {
+        // Adaptors unregister from the UIInstance once more when deleted, which does no harm
+        cache.removeAndReturn (0)->components.clear();
+        stats.rowsDeleted++;
+    }
+}
+
+void UIVirtualForm::layoutContent()
+{
+    // The content has no positioner, so nobody else lays out its children if we're resized during a pass
+    for (auto comp : pinned)
+        layout (*comp);
+    
+    for (int i = liveRows.getStart(); i < liveRows.getEnd(); ++i)
+        for (auto comp : rows[i]->components)
+            layout (*comp);
+}
+
+void UIVirtualForm::layout (Component& comp)
+{
+    if (auto positioner = comp.getPositioner())
+        positioner->applyNewBounds (content.getLocalBounds());
+}
+
+void UIVirtualForm::forEachAdaptor (Component& comp, const std::function<void(UIAdaptor&)>& function)
+{
+    if (auto adaptor = dynamic_cast<UIAdaptor*> (&comp))
+        function (*adaptor);
+    
+    for (auto child : comp.getChildren())
+        forEachAdaptor (*child, function);
+}
+
+String UIVirtualForm::Statistics::toString () const
+{
+    String out;
+    out << "Rows built: " << rowsBuilt
+        << ", reused: " << rowsReused
+        << ", deleted: " << rowsDeleted;
+    return out;
+}
+
+
 }//
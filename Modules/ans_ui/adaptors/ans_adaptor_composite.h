@@ -23,7 +23,8 @@ namespace ans {
     
 class UIComposite :
         public juce::Component,
-        public UIAdaptor
+        public UIAdaptor,
+        public AnchorSolver::Host
 {
 public:
     UIComposite (std::shared_ptr<UIInstance> instance, const CompositeSpecBase& spec);
@@ -40,14 +41,93 @@ public:
     void setBackgroundColour (Colour colour);
     
     void resized() override;
+    void childrenChanged() override;
     void paint (Graphics& g) override;
     
     void componentBuildBegin() override;
     void componentBuildEnd() override;
+    
+    AnchorSolver* getAnchorSolver (bool create) override;
 
 private:
     bool hasBackgroundColour;
     Colour backgroundColour;
+    std::unique_ptr<AnchorSolver> anchorSolver;
+};
+
+
+/**
+ UIVirtualForm is a scrolling form for very long lists of rows, e.g. one row per plugin parameter.
+ Rather than building a component for each of its child specs, it reads the vertical extent of
+ each row from the child's LayoutFrame, as streamed by LayoutCursor, and only builds the rows that
+ intersect the visible area plus some overscan. Children that share the same extent form a row.
+ 
+ Rows that scroll out of view are detached and their adaptors suspended, so only live rows
+ respond to the model. The most recently detached rows are kept for reuse and resumed when they
+ scroll back into view, older ones are deleted. Children whose vertical extent depends on the
+ size of the form or on siblings can't be placed without building them, so they're built right
+ away and stay live.
+ */
+
+class UIVirtualForm :
+        public juce::Viewport,
+        public UIAdaptor
+{
+public:
+    
+    /** Counters for judging how much building was saved while scrolling */
+    struct Statistics
+    {
+        int rowsBuilt = 0;      ///< Rows built from their specs
+        int rowsReused = 0;     ///< Rows taken back from the cache of detached rows
+        int rowsDeleted = 0;    ///< Detached rows deleted because the cache was full
+        
+        String toString() const;
+    };
+    
+    UIVirtualForm (std::shared_ptr<UIInstance> instance, const VirtualFormSpec& spec);
+   ~UIVirtualForm ();
+    
+    /** Number of rows, including those that aren't built */
+    int getNumRows() const { return rows.size(); }
+    
+    /** Number of rows currently built and attached */
+    int getNumLiveRows() const { return liveRows.getLength(); }
+    
+    const Statistics& getStatistics() const { return stats; }
+    
+    void resized() override;
+    void visibleAreaChanged (const juce::Rectangle<int>& newVisibleArea) override;
+    
+private:
+    struct Row
+    {
+        Range<int> extent;
+        Array<const ComponentSpec*> specs;
+        OwnedArray<Component> components;   // empty until built
+        bool live = false;
+    };
+    
+    void addRowSpec (const ComponentSpec* spec);
+    void updateLiveRows();
+    void attachRow (Row& row);
+    void detachRow (Row& row);
+    void layoutContent();
+    void layout (Component& comp);
+    Range<int> getRowsIntersecting (Range<int> area) const;
+    
+    static void forEachAdaptor (Component& comp, const std::function<void(UIAdaptor&)>& function);
+    
+    UIComposite content;
+    OwnedArray<Row> rows;           // sorted by top
+    Array<int> reach;               // running maximum of the bottoms of rows
+    Array<Row*> cache;              // detached rows, least recently used first
+    OwnedArray<Component> pinned;   // children without constant vertical extent
+    Range<int> liveRows;
+    int contentHeight = 0;
+    const int overscan;
+    const int cacheSize;
+    Statistics stats;
 };
 
 
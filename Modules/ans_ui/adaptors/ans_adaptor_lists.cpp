@@ -26,10 +26,13 @@ UIListBox::UIListBox (std::shared_ptr<UIInstance> instance, const ListSpec& spec
     initialiseFromSpec (instance, spec);
     ListBox::setMultipleSelectionEnabled (spec.enableMultipleSelection);
     ListBox::setModel (nullptr);
+    getVerticalScrollBar().addListener (this);
 }
 
 UIListBox::~UIListBox ()
 {
+    getVerticalScrollBar().removeListener (this);
+    
     if (listModel != nullptr)
         listModel->removeView (this);
     
@@ -49,12 +52,19 @@ void UIListBox::setComponentState (const Binding::Purpose& p, UIListModelBase& c
             ListBox::setModel (listModel);
         else
         {
-            ListBox::repaint();
+            repaintComponent();
             ListBox::updateContent();
         }
+        updateRowOpacity();
+        notifyVisibleRows();
     }
 }
 
+bool UIListBox::mustNotCull (const Binding::Purpose& p) const
+{
+    return p == Binding::Purpose::GetValue || UIAdaptor::mustNotCull (p);
+}
+
 void UIListBox::getComponentState (const Binding::Purpose& p, Selection& selection)
 {
     if (p == Binding::Purpose::SetSelection)
@@ -69,19 +79,14 @@ void UIListBox::setComponentState (const Binding::Purpose& p, Selection& selecti
 {
     if (p == Binding::Purpose::GetSelection)
     {
-        SparseSet<int> newSelection;
-        for (auto i : selection.getMulti())
-            newSelection.addRange(Range<int>(i, i+1));
-        
-        setSelectedRows (newSelection, dontSendNotification);
+        setSelectedRows (selection.getIndexes().getRanges(), dontSendNotification);
     }
 }
 
 Selection UIListBox::currentSelection()
 {
     Selection selection;
-    for (int i = 0; i < getNumSelectedRows(); ++i)
-        selection.setSelectionOf (getSelectedRow (i), true);
+    selection.setMulti (SelectionSet::fromRanges (getSelectedRows()));
     return selection;
 }
 
@@ -98,5 +103,84 @@ void UIListBox::someViewChangedSelection()
         performBinding (Binding::Purpose::SetSelection);
 }
 
+void UIListBox::applyListChange (const UIListChange& change)
+{
+    if (listModel == nullptr || ListBox::getModel() != listModel)
+        return;
+    
+    // Rows on screen only repaint themselves if their index or selection state changes
+    ListBox::updateContent();
+    setSelectedRows (listModel->getSelection().getIndexes().getRanges(), dontSendNotification);
+    repaintRows (change.getAffectedRows());
+    updateRowOpacity();
+    notifyVisibleRows();
+}
+
+void UIListBox::repaintRows (Range<int> rows)
+{
+    auto visible = getVisibleRows().getIntersectionWith (rows);
+    auto batcher = RepaintBatcher::getInstance();
+    
+    // Adjacent rows merge into one rectangle
+    for (int row = visible.getStart(); row < visible.getEnd(); ++row)
+        batcher->add (*this, getRowPosition (row, true));
+}
+
+Range<int> UIListBox::getVisibleRows()
+{
+    const int first = getViewport()->getViewPositionY() / jmax (1, getRowHeight());
+    return Range<int> (first, first + getNumRowsOnScreen() + 1);
+}
+
+void UIListBox::updateRowOpacity()
+{
+    const bool opaque = listModel != nullptr && listModel->areRowsOpaque();
+    
+    // The row components are the children of the viewport's content
+    if (auto content = getViewport()->getViewedComponent())
+        for (int i = 0; i < content->getNumChildComponents(); ++i)
+            content->getChildComponent (i)->setOpaque (opaque);
+}
+
+void UIListBox::resized()
+{
+    ListBox::resized();
+    updateRowOpacity();
+    notifyVisibleRows();
+}
+
+void UIListBox::lookAndFeelChanged()
+{
+    ListBox::lookAndFeelChanged();
+    if (listModel != nullptr)
+        listModel->refreshRenderCache();
+}
+
+void UIListBox::colourChanged()
+{
+    ListBox::colourChanged();
+    if (listModel != nullptr)
+        listModel->refreshRenderCache();
+}
+
+void UIListBox::scrollBarMoved (ScrollBar* bar, double newRangeStart)
+{
+    notifyVisibleRows();
+}
+
+void UIListBox::notifyVisibleRows()
+{
+    if (listModel != nullptr)
+        listModel->visibleRowsChanged (getVisibleRows());
+}
+
+
+//==========================================================================================================
+#if 0
+#pragma mark UIListSortThreads
+#endif
+
+JUCE_IMPLEMENT_SINGLETON (UIListSortThreads)
+
 }
 
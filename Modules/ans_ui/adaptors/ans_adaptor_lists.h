@@ -30,6 +30,43 @@ namespace PrintHelpers
 class UIListModelBase;
 
 
+/**
+ UIListChange describes an incremental modification of a UIListModel, so that views can update only
+ what is affected instead of reloading the entire list.
+ */
+
+struct UIListChange
+{
+    enum Type
+    {
+        Inserted,   ///< rows are the indexes of the new items
+        Removed,    ///< rows are the indexes the items had before removal
+        Moved,      ///< rows were moved as a block, so that the first one is now at destination
+        Changed,    ///< the items in rows changed their contents in place
+        Reloaded    ///< the entire list was replaced, rows covers the new list
+    };
+    
+    Type type;
+    Range<int> rows;
+    int destination = -1;
+    
+    /** Return the rows that display different items (or contents) after the change */
+    Range<int> getAffectedRows() const
+    {
+        switch (type)
+        {
+            case Inserted:
+            case Removed:
+            case Reloaded:  return Range<int> (rows.getStart(), std::numeric_limits<int>::max());
+            case Moved:     return Range<int> (jmin (rows.getStart(), destination),
+                                               jmax (rows.getEnd(), destination + rows.getLength()));
+            case Changed:   return rows;
+        }
+        return rows;
+    }
+};
+
+
 /**
  UIListBox extends ListBox for communication with UIModel.
  UIModel is responsible for providing a UIListModel this adaptor operates on.
@@ -37,7 +74,8 @@ class UIListModelBase;
 
 class UIListBox :
         public juce::ListBox,
-        public UIAdaptor
+        public UIAdaptor,
+        private juce::ScrollBar::Listener
 {
 public:
     UIListBox (std::shared_ptr<UIInstance> instance, const ListSpec& spec);
@@ -49,8 +87,30 @@ public:
     
     void someViewChangedSelection();
     
+    /** Called by UIListModel to update only the rows affected by an incremental change */
+    void applyListChange (const UIListChange& change);
+    
+    /** Repaint those rows of a range that are currently on screen */
+    void repaintRows (Range<int> rows);
+    
+    /** Return the range of rows currently on screen */
+    Range<int> getVisibleRows();
+    
+    /** Make the row components opaque (or not), as requested by the list model */
+    void updateRowOpacity();
+    
+    void resized() override;
+    void lookAndFeelChanged() override;
+    void colourChanged() override;
+    
+protected:
+    /** ListBox keeps a raw pointer to the list model, which must follow the model even while hidden */
+    bool mustNotCull (const Binding::Purpose& p) const override;
+    
 private:
     Selection currentSelection();
+    void scrollBarMoved (ScrollBar* bar, double newRangeStart) override;
+    void notifyVisibleRows();
     
     WeakReference<UIListModelBase> listModel;
 };
@@ -80,8 +140,69 @@ public:
         views.call ([](auto& view) { view.someViewChangedSelection(); });
     }
     
+    /** Called by views whenever the range of rows on screen changes, e.g. for prefetching */
+    virtual void visibleRowsChanged (Range<int> rows) {}
+    
+    /** Called by views when colours or fonts may have changed, so cached renderings must be dropped */
+    virtual void refreshRenderCache() {}
+    
+    /**
+     Have rows fill their entire background, so that views can make their row components opaque
+     and needn't paint anything behind them. Subclasses that paint rows themselves must then fill
+     the background of every row, including unselected and empty ones (@see areRowsOpaque).
+     */
+    void setOpaqueRows (bool shouldBeOpaque)
+    {
+        opaqueRows = shouldBeOpaque;
+        views.call ([](auto& view) { view.updateRowOpacity(); });
+    }
+    
+    bool areRowsOpaque() const { return opaqueRows; }
+    
+    /** Receives all changes of a list model, e.g. to maintain an index view on it */
+    struct Listener
+    {
+        virtual ~Listener() {}
+        
+        /** Called before objects may be deleted or the entire list is replaced */
+        virtual void listAboutToChange() {}
+        
+        /** Called after the list has changed */
+        virtual void listChanged (const UIListChange& change) = 0;
+    };
+    
+    void addListener (Listener* l) { listeners.add (l); }
+    void removeListener (Listener* l) { listeners.remove (l); }
+    
 protected:
+    
+    /** Have all views apply an incremental change, after the list and selection have been updated */
+    void sendChange (const UIListChange& change)
+    {
+        invalidateRenderCache (change);
+        views.call ([&](auto& view) { view.applyListChange (change); });
+        listeners.call ([&](auto& l) { l.listChanged (change); });
+    }
+    
+    void sendAboutToChange()
+    {
+        listeners.call ([](auto& l) { l.listAboutToChange(); });
+    }
+    
+    /** Tell listeners the list was replaced. Views are updated through their bindings instead */
+    void sendReload()
+    {
+        const UIListChange change { UIListChange::Reloaded, Range<int> (0, getNumRows()) };
+        invalidateRenderCache (change);
+        listeners.call ([&](auto& l) { l.listChanged (change); });
+    }
+    
+    /** Drop cached renderings of rows affected by a change */
+    virtual void invalidateRenderCache (const UIListChange& change) {}
+    
     ListenerList<UIListBox> views;
+    ListenerList<Listener> listeners;
+    bool opaqueRows = false;
     
     JUCE_DECLARE_WEAK_REFERENCEABLE (UIListModelBase)
 };
@@ -120,10 +241,13 @@ public:
      */
     void setList (const Array<ObjectClass*>& items)
     {
+        sendAboutToChange();
         data.clear();
         pointers.clear();
         pointers.addArray (items);
+        rebuildIndex();
         ensureValidSelection();
+        sendReload();
     }
     
     /**
@@ -132,11 +256,14 @@ public:
      */
     void setListReference (Array<ObjectClass>& items)
     {
+        sendAboutToChange();
         data.clear();
         pointers.clear();
         for (auto& each : items)
             pointers.add (&each);
+        rebuildIndex();
         ensureValidSelection();
+        sendReload();
     }
     
     /**
@@ -146,6 +273,7 @@ public:
      */
     void setListData (const Array<ObjectClass>& items)
     {
+        sendAboutToChange();
         data.clear();
         pointers.clear();
         for (auto& each : items)
@@ -154,7 +282,103 @@ public:
             pointers.add (o);
             data.add (o);
         }
+        rebuildIndex();
         ensureValidSelection();
+        sendReload();
+    }
+    
+    /**
+     Insert pointers to objects at index (or append them, if index is out of range). Like setList(),
+     this does not take ownership. Views update incrementally, and selected rows above index move
+     along with their items.
+     */
+    void insertItems (int index, const Array<ObjectClass*>& items)
+    {
+        if (items.isEmpty())
+            return;
+        
+        index = isPositiveAndBelow (index, pointers.size()) ? index : pointers.size();
+        pointers.insertArray (index, items.begin(), items.size());
+        reindexFrom (index);
+        selection.insertSpace (index, items.size());
+        sendChange ({ UIListChange::Inserted, Range<int> (index, index + items.size()) });
+    }
+    
+    /** Append pointers to objects, e.g. for a live log. See insertItems() */
+    void appendItems (const Array<ObjectClass*>& items)
+    {
+        insertItems (-1, items);
+    }
+    
+    /** Insert copies of objects at index, kept by the model like those supplied with setListData() */
+    void insertItemData (int index, const Array<ObjectClass>& items)
+    {
+        Array<ObjectClass*> copies;
+        for (auto& each : items)
+            copies.add (data.add (new ObjectClass (each)));
+        insertItems (index, copies);
+    }
+    
+    /** Append copies of objects, kept by the model like those supplied with setListData() */
+    void appendItemData (const Array<ObjectClass>& items)
+    {
+        insertItemData (-1, items);
+    }
+    
+    /** Remove a range of rows. Objects are deleted only if they were supplied as data */
+    void removeItems (Range<int> range)
+    {
+        range = range.getIntersectionWith (Range<int> (0, pointers.size()));
+        if (range.isEmpty())
+            return;
+        
+        sendAboutToChange();
+        
+        for (int i = range.getStart(); i < range.getEnd(); ++i)
+        {
+            auto item = pointers.getUnchecked (i);
+            if (rows[item] >= range.getStart())
+                rows.remove (item);
+        }
+        
+        Array<ObjectClass*> removed (pointers.begin() + range.getStart(), range.getLength());
+        pointers.removeRange (range.getStart(), range.getLength());
+        reindexFrom (range.getStart());
+        selection.removeSpace (range);
+        ensureValidSelection();
+        sendChange ({ UIListChange::Removed, range });
+        
+        // Delete owned objects last, as listeners may still refer to them
+        if (! data.isEmpty())
+            deleteOwned (removed);
+    }
+    
+    /**
+     Move a block of rows, so that its first row ends up at destination. Selected rows move along
+     with their items.
+     */
+    void moveItems (Range<int> range, int destination)
+    {
+        range = range.getIntersectionWith (Range<int> (0, pointers.size()));
+        destination = jlimit (0, pointers.size() - range.getLength(), destination);
+        
+        if (range.isEmpty() || destination == range.getStart())
+            return;
+        
+        Array<ObjectClass*> moved (pointers.begin() + range.getStart(), range.getLength());
+        pointers.removeRange (range.getStart(), range.getLength());
+        pointers.insertArray (destination, moved.begin(), moved.size());
+        reindexFrom (jmin (range.getStart(), destination));
+        selection.moveSpace (range, destination);
+        sendChange ({ UIListChange::Moved, range, destination });
+    }
+    
+    /** Tell views that the objects in a range of rows have changed their contents and need repainting */
+    void itemsChanged (Range<int> range)
+    {
+        range = range.getIntersectionWith (Range<int> (0, pointers.size()));
+        if (! range.isEmpty())
+            sendChange ({ UIListChange::Changed, range });
     }
     
     /** Get a reference to the array of pointers to your objects */
@@ -166,16 +390,22 @@ public:
      */
     DataType& getListData()  { return data; }
     
+    /** Return the row of an object in constant time, or -1 if it isn't in the list */
+    int indexOf (ObjectClass* item) const
+    {
+        return rows.contains (item) ? rows[item] : -1;
+    }
+    
     /** Query selection state of a particular object */
     bool isSelected (ObjectClass* item)
     {
-        return selection.contains (pointers.indexOf(item));
+        return selection.contains (indexOf (item));
     }
     
     /** Select or deselect a particular object incrementally */
     void setSelectionOf (ObjectClass* item, bool state)
     {
-        selection.setSelectionOf (pointers.indexOf(item), state);
+        selection.setSelectionOf (indexOf (item), state);
     }
     
     /**
@@ -198,8 +428,9 @@ public:
             selection.clear();
         else
         {
-            jassert (pointers.indexOf (item) >= 0);
-            selection.set (pointers.indexOf (item));
+            const int index = indexOf (item);
+            jassert (index >= 0);
+            selection.set (index);
         }
         ensureValidSelection();
     }
@@ -217,8 +448,27 @@ public:
     void setMultipleSelection (const Array<ObjectClass*>& items)
     {
         Selection newSelection (selection.isMultipleSelectionEnabled(), selection.isNullSelectionEnabled());
-        for (auto item : items)
-            newSelection.setSelectionOf (pointers.indexOf (item), true);
+        
+        if (! selection.isMultipleSelectionEnabled())
+        {
+            for (auto item : items)
+                newSelection.setSelectionOf (indexOf (item), true);
+        }
+        else
+        {
+            // Adding in ascending order only ever extends or appends the last run
+            Array<int> indexes;
+            indexes.ensureStorageAllocated (items.size());
+            for (auto item : items)
+            {
+                const int i = indexOf (item);
+                if (i >= 0)
+                    indexes.add (i);
+            }
+            indexes.sort();
+            
+            newSelection.setMulti (SelectionSet::fromSortedIndexes (indexes));
+        }
         setSelection (newSelection);
     }
     
@@ -230,19 +480,34 @@ public:
     
     void paintListBoxItem (int rowNumber, Graphics &g, int width, int height, bool rowIsSelected) override
     {
-        if (rowNumber >= pointers.size())
-            return;
+        paintRow (rowNumber, g, width, height, rowIsSelected, opaqueRows);
+    }
+    
+    /**
+     Paint a row, using cached text layouts. Opaque rows fill their background, even if they are
+     beyond the end of the list.
+     */
+    void paintRow (int rowNumber, Graphics &g, int width, int height, bool rowIsSelected, bool opaque)
+    {
+        updateRenderStyle();
         
         if (rowIsSelected)
-            g.fillAll (LookAndFeel::getDefaultLookAndFeel().findColour (TextEditor::highlightColourId));
+            g.fillAll (highlightColour);
+        else if (opaque)
+            g.fillAll (backgroundColour);
         
-        g.setColour (LookAndFeel::getDefaultLookAndFeel().findColour (ListBox::textColourId));
-        Font f (height * 0.7f);
-        f.setHorizontalScale (1.0f);
-        g.setFont (f);
-        g.drawText (PrintHelpers::print (*pointers[rowNumber]),
-                    4, 0, width - 6, height,
-                    Justification::centredLeft, true);
+        if (! isPositiveAndBelow (rowNumber, pointers.size()))
+            return;
+        
+        g.setColour (textColour);
+        getRowGlyphs (rowNumber, width, height).draw (g);
+    }
+    
+    void refreshRenderCache() override
+    {
+        styleValid = false;
+        fontHeight = -1;
+        rowCache.clear();
     }
     
     //void deleteKeyPressed (int lastRowSelected) override;
@@ -258,6 +523,60 @@ public:
     
 private:
     
+    /**
+     Delete owned objects that are no longer listed. The owned data is compacted in a single pass,
+     rather than searching and shifting it once per object.
+     */
+    void deleteOwned (const Array<ObjectClass*>& removed)
+    {
+        HashMap<ObjectClass*, bool> doomed;
+        for (auto item : removed)
+            if (! rows.contains (item))
+                doomed.set (item, true);
+        
+        if (doomed.size() == 0)
+            return;
+        
+        Array<ObjectClass*> deleted;
+        int kept = 0;
+        
+        for (int i = 0; i < data.size(); ++i)
+        {
+            auto item = data.getUnchecked (i);
+            if (doomed.contains (item))
+                deleted.add (item);
+            else
+                data.set (kept++, item, false);
+        }
+        
+        data.removeRange (kept, data.size() - kept, false);
+        
+        for (auto item : deleted)
+            ContainerDeletePolicy<ObjectClass>::destroy (item);
+    }
+    
+    /** Map each object to its row. Duplicates map to their first occurrence, like Array::indexOf() */
+    void rebuildIndex()
+    {
+        rows.clear();
+        if (rows.getNumSlots() < pointers.size())
+            rows.remapTable (pointers.size());
+        
+        for (int i = pointers.size(); --i >= 0;)
+            rows.set (pointers.getUnchecked (i), i);
+    }
+    
+    /** Update the index for rows >= from, after they were shifted. Rows below are still valid */
+    void reindexFrom (int from)
+    {
+        for (int i = pointers.size(); --i >= from;)
+        {
+            auto item = pointers.getUnchecked (i);
+            if (! rows.contains (item) || rows[item] >= from)
+                rows.set (item, i);
+        }
+    }
+    
     void ensureValidSelection() override
     {
         selection.constrain (pointers.size());
@@ -270,8 +589,1006 @@ private:
         }
     }
     
+    /** Text of a row laid out for a particular row size, valid as long as the row shows the same item */
+    struct RowGlyphs
+    {
+        ObjectClass* item = nullptr;
+        int width = 0;
+        int height = 0;
+        GlyphArrangement glyphs;
+    };
+    
+    void updateRenderStyle()
+    {
+        if (styleValid)
+            return;
+        
+        auto& lf = LookAndFeel::getDefaultLookAndFeel();
+        textColour = lf.findColour (ListBox::textColourId);
+        highlightColour = lf.findColour (TextEditor::highlightColourId);
+        backgroundColour = lf.findColour (ListBox::backgroundColourId);
+        styleValid = true;
+    }
+    
+    const GlyphArrangement& getRowGlyphs (int row, int width, int height)
+    {
+        auto item = pointers.getUnchecked (row);
+        
+        // Only rows on screen need to be cached, so don't let this grow forever
+        if (rowCache.size() >= maxCachedRows && rowCache.find (row) == rowCache.end())
+            rowCache.clear();
+        
+        auto& entry = rowCache[row];
+        
+        if (entry.item != item || entry.width != width || entry.height != height)
+        {
+            if (fontHeight != height)
+            {
+                rowFont = Font (height * 0.7f);
+                rowFont.setHorizontalScale (1.0f);
+                fontHeight = height;
+            }
+            
+            const float baseline = (height + rowFont.getAscent() - rowFont.getDescent()) * 0.5f;
+            
+            entry.item = item;
+            entry.width = width;
+            entry.height = height;
+            entry.glyphs.clear();
+            entry.glyphs.addCurtailedLineOfText (rowFont, PrintHelpers::print (*item), 4.0f, baseline, (float) (width - 6), true);
+        }
+        return entry.glyphs;
+    }
+    
+    void invalidateRenderCache (const UIListChange& change) override
+    {
+        if (change.type == UIListChange::Reloaded)
+            return rowCache.clear();
+        
+        const auto affected = change.getAffectedRows();
+        
+        for (auto it = rowCache.begin(); it != rowCache.end();)
+            if (affected.contains (it->first))
+                it = rowCache.erase (it);
+            else
+                ++it;
+    }
+    
     ListType  pointers;
     DataType  data; // optional only
+    HashMap<ObjectClass*, int> rows;
+    
+    static constexpr size_t maxCachedRows = 512;
+    std::unordered_map<int, RowGlyphs> rowCache;
+    Font rowFont;
+    int fontHeight = -1;
+    Colour textColour, highlightColour, backgroundColour;
+    bool styleValid = false;
+};
+
+
+/** The worker threads shared by all UIListModelViews for sorting in the background */
+
+class UIListSortThreads :
+        public ThreadPool,
+        public DeletedAtShutdown
+{
+public:
+    UIListSortThreads () : ThreadPool (jmax (1, SystemStats::getNumCpus() - 1)) {}
+   ~UIListSortThreads () { clearSingletonInstance(); }
+    
+    JUCE_DECLARE_SINGLETON (UIListSortThreads, true)
+};
+
+
+/**
+ UIListModelView presents a filtered and/or sorted view on a UIListModel, without copying or
+ reordering the underlying list. It keeps a vector mapping its own rows to rows of the source model
+ and can be bound to a UIListBox just like the source itself, so several views may show the same
+ list in different ways.
+ 
+ Narrowing a filter (e.g. while typing into a search field) only re-tests the rows currently in
+ view, and incremental changes of the source (see UIListModel::insertItems() etc.) are mapped onto
+ the view as they arrive. Sorting large lists is done in parallel on worker threads shared by all
+ views, while the view keeps showing the filtered rows in source order until the result arrives.
+ The comparator must therefore be safe to call from other threads, and must not modify the objects.
+ Changes of the source while a sort is running are applied to the rows in view right away, and
+ the sort is restarted once per burst of changes. If changes keep cancelling it, the view is
+ sorted on the message thread instead, so it ends up sorted even if the source never rests.
+ 
+ Selections are kept in terms of source rows, so they survive re-sorting and changing filters.
+ The source model must outlive its views.
+ */
+
+template <typename ObjectClass>
+class UIListModelView :
+        public UIListModelBase,
+        private UIListModelBase::Listener,
+        private AsyncUpdater
+{
+public:
+    
+    using Predicate = std::function<bool (const ObjectClass&)>;
+    
+    /** Must return true, if the first object is to be listed before the second */
+    using Comparator = std::function<bool (const ObjectClass&, const ObjectClass&)>;
+    
+    UIListModelView (UIListModel<ObjectClass>& sourceModel, bool enableMultiSelection = false, bool enableEmptySelection = true) :
+        UIListModelBase (enableMultiSelection, enableEmptySelection),
+        source (sourceModel),
+        sourceRef (&sourceModel)
+    {
+        source.addListener (this);
+        rebuild();
+    }
+    
+   ~UIListModelView ()
+    {
+        if (sourceRef != nullptr)
+            source.removeListener (this);
+        
+        // Waits for running sort jobs
+        cancelSort();
+    }
+    
+    /** Show only rows whose objects pass a predicate, or all rows if it is nullptr */
+    void setFilter (Predicate predicateToUse)
+    {
+        predicate = predicateToUse;
+        rebuild();
+    }
+    
+    /**
+     Replace the filter with one that is at least as strict, e.g. after more characters were typed
+     into a search field. Only the rows currently in view are tested against the new predicate.
+     */
+    void refineFilter (Predicate stricterPredicate)
+    {
+        predicate = stricterPredicate;
+        
+        if (sortPending || predicate == nullptr)
+            return rebuild();
+        
+        Array<int> removed;
+        for (int v = rowMap.size(); --v >= 0;)
+            if (! passes (rowMap.getUnchecked (v)))
+                removed.add (v);
+        
+        removeFromView (removed);
+    }
+    
+    /** Sort the view with a comparator, or restore source order if it is nullptr */
+    void setSortOrder (Comparator comparatorToUse)
+    {
+        comparator = comparatorToUse;
+        rebuild();
+    }
+    
+    /** Views with at least this many rows are sorted on worker threads */
+    void setParallelSortThreshold (int numRows) { parallelSortThreshold = numRows; }
+    
+    /** Whether a sort is still running in the background */
+    bool isSortPending() const { return sortPending; }
+    
+    /** Return the source row shown at a row of this view */
+    int getSourceRow (int viewRow) const { return rowMap[viewRow]; }
+    
+    /** Return the row of this view showing a source row, or -1 if it is filtered out */
+    int getViewRow (int sourceRow)
+    {
+        const auto& rows = getInverse();
+        return isPositiveAndBelow (sourceRow, rows.size()) ? rows.getUnchecked (sourceRow) : -1;
+    }
+    
+    /** Return the object shown at a row of this view */
+    ObjectClass* getObject (int viewRow)
+    {
+        return isPositiveAndBelow (viewRow, rowMap.size()) ? source.getList()[rowMap.getUnchecked (viewRow)] : nullptr;
+    }
+    
+    /** Get the selected source rows, including those currently filtered out */
+    const SelectionSet& getSourceSelection() const { return sourceSelection.getIndexes(); }
+    
+    /** Get a pointer to the first selected object in view */
+    ObjectClass* getSingleSelection()
+    {
+        return getObject (selection.get());
+    }
+    
+    /** Get pointers to the selected objects, including those currently filtered out */
+    Array<ObjectClass*> getMultipleSelection()
+    {
+        Array<ObjectClass*> answer;
+        for (auto i : sourceSelection.getIndexes())
+            answer.add (source.getList()[i]);
+        return answer;
+    }
+    
+    int  getNumRows() override { return rowMap.size(); }
+    
+    void paintListBoxItem (int rowNumber, Graphics &g, int width, int height, bool rowIsSelected) override
+    {
+        const int sourceRow = isPositiveAndBelow (rowNumber, rowMap.size()) ? rowMap.getUnchecked (rowNumber) : -1;
+        source.paintRow (sourceRow, g, width, height, rowIsSelected, opaqueRows);
+    }
+    
+    void refreshRenderCache() override
+    {
+        source.refreshRenderCache();
+    }
+    
+private:
+    
+    /** Shared with the worker threads of an asynchronous sort */
+    struct SortTask
+    {
+        Array<int> rows;
+        Array<ObjectClass*> objects;
+        Comparator less;
+        int chunkSize = 0;
+        std::atomic<int> remaining { 0 };
+        std::atomic<bool> cancelled { false };
+        uint32 generation = 0;
+        WeakReference<UIListModelBase> owner;
+        
+        /** Once cancelled, objects are no longer looked at, so the sort runs out quickly */
+        bool compare (int a, int b) const
+        {
+            return ! cancelled.load (std::memory_order_relaxed)
+                && less (*objects.getUnchecked (a), *objects.getUnchecked (b));
+        }
+    };
+    
+    /** Sorts one chunk of a SortTask */
+    class SortJob : public ThreadPoolJob
+    {
+    public:
+        SortJob (std::shared_ptr<SortTask> t, int c) : ThreadPoolJob ("Sort list view"), task (t), chunk (c) {}
+        
+        JobStatus runJob() override
+        {
+            auto first = task->rows.begin() + jmin (task->rows.size(), chunk * task->chunkSize);
+            auto last  = task->rows.begin() + jmin (task->rows.size(), (chunk + 1) * task->chunkSize);
+            std::stable_sort (first, last, [this](int a, int b) { return task->compare (a, b); });
+            
+            // Whoever finishes last merges the sorted chunks
+            if (--task->remaining == 0 && ! task->cancelled)
+                mergeChunks (task);
+            
+            return jobHasFinished;
+        }
+        
+        std::shared_ptr<SortTask> task;
+        const int chunk;
+    };
+    
+    /** Selects the jobs of a single task */
+    struct SortJobSelector : public ThreadPool::JobSelector
+    {
+        SortJobSelector (const SortTask* t) : task (t) {}
+        
+        bool isJobSuitable (ThreadPoolJob* job) override
+        {
+            auto sortJob = dynamic_cast<SortJob*> (job);
+            return sortJob != nullptr && sortJob->task.get() == task;
+        }
+        
+        const SortTask* task;
+    };
+    
+    bool passes (int sourceRow)
+    {
+        return predicate == nullptr || predicate (*source.getList().getUnchecked (sourceRow));
+    }
+    
+    const Array<int>& getInverse()
+    {
+        if (! inverseValid)
+        {
+            inverse.clearQuick();
+            inverse.insertMultiple (0, -1, source.getNumRows());
+            for (int v = 0; v < rowMap.size(); ++v)
+                inverse.set (rowMap.getUnchecked (v), v);
+            inverseValid = true;
+        }
+        return inverse;
+    }
+    
+    /** Whether the rows in view are kept in the order of the comparator, rather than in source order while a sort is pending */
+    bool isOrdered() const { return comparator != nullptr && ! sortPending; }
+    
+    /** Recreate the row map from scratch and start sorting it, if needed */
+    void rebuild()
+    {
+        cancelSort();
+        sortPending = false;
+        cancelledSorts = 0;
+        
+        Array<int> rows;
+        rows.ensureStorageAllocated (source.getNumRows());
+        for (int i = 0; i < source.getNumRows(); ++i)
+            if (passes (i))
+                rows.add (i);
+        
+        if (comparator != nullptr)
+        {
+            if (rows.size() >= parallelSortThreshold)
+                startSort (rows);
+            else
+                std::stable_sort (rows.begin(), rows.end(), [this](int a, int b)
+                {
+                    return comparator (*source.getList().getUnchecked (a), *source.getList().getUnchecked (b));
+                });
+        }
+        setRowMap (rows);
+    }
+    
+    void setRowMap (const Array<int>& rows)
+    {
+        rowMap = rows;
+        inverseValid = false;
+        selectFromSource();
+        sendChange ({ UIListChange::Reloaded, Range<int> (0, rowMap.size()) });
+    }
+    
+    /** Selection follows the source rows */
+    void selectFromSource()
+    {
+        Array<int> viewRows;
+        for (auto s : sourceSelection.getIndexes())
+        {
+            const int v = getViewRow (s);
+            if (v >= 0)
+                viewRows.add (v);
+        }
+        viewRows.sort();
+        selection.setMulti (SelectionSet::fromSortedIndexes (viewRows));
+    }
+    
+    /**
+     Remove view rows given in descending order. The row map is compacted in a single pass, and views
+     are told once: about the removed block if it is contiguous, or else to reload.
+     */
+    void removeFromView (const Array<int>& descendingRows)
+    {
+        if (descendingRows.isEmpty())
+            return;
+        
+        const int first = descendingRows.getLast();
+        const int last = descendingRows.getFirst();
+        
+        int next = descendingRows.size() - 1;
+        int kept = first;
+        
+        for (int v = first; v < rowMap.size(); ++v)
+        {
+            if (next >= 0 && descendingRows.getUnchecked (next) == v)
+            {
+                --next;
+                continue;
+            }
+            rowMap.set (kept++, rowMap.getUnchecked (v));
+        }
+        
+        rowMap.removeRange (kept, rowMap.size() - kept);
+        inverseValid = false;
+        
+        if (last - first + 1 == descendingRows.size())
+        {
+            const Range<int> block (first, last + 1);
+            selection.removeSpace (block);
+            sendChange ({ UIListChange::Removed, block });
+        }
+        else
+        {
+            selectFromSource();
+            sendChange ({ UIListChange::Reloaded, Range<int> (0, rowMap.size()) });
+        }
+    }
+    
+    void startSort (const Array<int>& rows)
+    {
+        auto pool = UIListSortThreads::getInstance();
+        
+        task = std::make_shared<SortTask>();
+        task->rows = rows;
+        task->objects = source.getList();
+        task->less = comparator;
+        task->generation = ++generation;
+        task->owner = this;
+        
+        const int numChunks = jlimit (1, pool->getNumThreads(), rows.size() / 4096);
+        task->chunkSize = (rows.size() + numChunks - 1) / numChunks;
+        task->remaining = numChunks;
+        sortPending = true;
+        
+        for (int c = 0; c < numChunks; ++c)
+            pool->addJob (new SortJob (task, c), true);
+    }
+    
+    /** Stop a running sort and wait for its jobs, which stop comparing objects right away */
+    void cancelSort()
+    {
+        ++generation;
+        
+        if (task == nullptr)
+            return;
+        
+        task->cancelled = true;
+        
+        if (auto pool = UIListSortThreads::getInstanceWithoutCreating())
+        {
+            SortJobSelector selector (task.get());
+            pool->removeAllJobs (true, -1, &selector);
+        }
+        task = nullptr;
+    }
+    
+    /** Restart a sort that changes of the source cancelled, once they are done for now */
+    void handleAsyncUpdate() override
+    {
+        if (! sortPending || task != nullptr || comparator == nullptr)
+            return;
+        
+        if (cancelledSorts < maxCancelledSorts)
+            return startSort (rowMap);
+        
+        // The source changes faster than we can sort in the background
+        Array<int> rows (rowMap);
+        std::stable_sort (rows.begin(), rows.end(), [this](int a, int b)
+        {
+            return comparator (*source.getList().getUnchecked (a), *source.getList().getUnchecked (b));
+        });
+        
+        sortPending = false;
+        cancelledSorts = 0;
+        setRowMap (rows);
+    }
+    
+    static void mergeChunks (std::shared_ptr<SortTask> task)
+    {
+        auto begin = task->rows.begin();
+        const int n = task->rows.size();
+        
+        for (int width = task->chunkSize; width < n; width *= 2)
+            for (int lo = 0; lo + width < n; lo += 2 * width)
+                std::inplace_merge (begin + lo, begin + lo + width, begin + jmin (n, lo + 2 * width),
+                                    [&](int a, int b) { return task->compare (a, b); });
+        
+        if (task->cancelled)
+            return;
+        
+        MessageManager::callAsync ([task]
+        {
+            if (auto view = dynamic_cast<UIListModelView*> (task->owner.get()))
+                view->sortArrived (*task);
+        });
+    }
+    
+    void sortArrived (const SortTask& result)
+    {
+        // Anything that happened meanwhile cancelled the sort
+        if (! sortPending || result.generation != generation)
+            return;
+        
+        task = nullptr;
+        sortPending = false;
+        cancelledSorts = 0;
+        setRowMap (result.rows);
+    }
+    
+    //======================================================================================================
+    
+    void listAboutToChange() override
+    {
+        // The source may delete or modify objects that a running sort is still looking at
+        if (task != nullptr)
+        {
+            cancelSort();
+            ++cancelledSorts;
+        }
+    }
+    
+    void listChanged (const UIListChange& change) override
+    {
+        // Not every change is announced by listAboutToChange(), but any makes a running sort stale
+        if (task != nullptr)
+        {
+            cancelSort();
+            ++cancelledSorts;
+        }
+        
+        switch (change.type)
+        {
+            case UIListChange::Inserted:
+                sourceSelection.insertSpace (change.rows.getStart(), change.rows.getLength());
+                sourceRowsInserted (change.rows);
+                break;
+                
+            case UIListChange::Removed:
+                sourceSelection.removeSpace (change.rows);
+                sourceRowsRemoved (change.rows);
+                break;
+                
+            case UIListChange::Moved:
+                sourceSelection.moveSpace (change.rows, change.destination);
+                return rebuild();
+                
+            case UIListChange::Changed:
+                sourceRowsChanged (change.rows);
+                break;
+                
+            case UIListChange::Reloaded:
+                sourceSelection.constrain (source.getNumRows());
+                return rebuild();
+        }
+        
+        // Rows in view were kept up to date in source order, so sorting them can start over
+        if (sortPending && task == nullptr)
+            triggerAsyncUpdate();
+    }
+    
+    void sourceRowsInserted (Range<int> rows)
+    {
+        // Appending, e.g. to a log, shifts nothing
+        if (rows.getEnd() < source.getNumRows())
+            for (auto& s : rowMap)
+                if (s >= rows.getStart())
+                    s += rows.getLength();
+        
+        inverseValid = false;
+        
+        if (! isOrdered())
+        {
+            Array<int> added;
+            for (int i = rows.getStart(); i < rows.getEnd(); ++i)
+                if (passes (i))
+                    added.add (i);
+            
+            if (added.isEmpty())
+                return;
+            
+            // Unsorted views list source rows in ascending order
+            const int pos = (int) (std::lower_bound (rowMap.begin(), rowMap.end(), rows.getStart()) - rowMap.begin());
+            rowMap.insertArray (pos, added.begin(), added.size());
+            selection.insertSpace (pos, added.size());
+            sendChange ({ UIListChange::Inserted, Range<int> (pos, pos + added.size()) });
+        }
+        else
+        {
+            Array<int> added;
+            for (int i = rows.getStart(); i < rows.getEnd(); ++i)
+                if (passes (i))
+                    added.add (i);
+            
+            insertIntoView (added);
+        }
+    }
+    
+    /**
+     Insert source rows where they belong in view. Several rows are sorted among themselves and
+     merged into the row map in a single pass, and views are told to reload once.
+     */
+    void insertIntoView (Array<int> sourceRows)
+    {
+        if (sourceRows.size() < 2)
+        {
+            for (auto s : sourceRows)
+                insertIntoView (s);
+            return;
+        }
+        
+        const auto& list = source.getList();
+        const bool ordered = isOrdered();
+        
+        auto less = [&](int a, int b)
+        {
+            return ordered ? comparator (*list.getUnchecked (a), *list.getUnchecked (b)) : a < b;
+        };
+        
+        std::stable_sort (sourceRows.begin(), sourceRows.end(), less);
+        
+        // Rows already in view come first among equals, like with upper_bound()
+        Array<int> merged;
+        merged.resize (rowMap.size() + sourceRows.size());
+        std::merge (rowMap.begin(), rowMap.end(), sourceRows.begin(), sourceRows.end(), merged.begin(), less);
+        
+        rowMap.swapWith (merged);
+        inverseValid = false;
+        selectFromSource();
+        sendChange ({ UIListChange::Reloaded, Range<int> (0, rowMap.size()) });
+    }
+    
+    /** Insert a single source row where it belongs in view */
+    void insertIntoView (int sourceRow)
+    {
+        const auto& list = source.getList();
+        int pos;
+        
+        if (isOrdered())
+            pos = (int) (std::upper_bound (rowMap.begin(), rowMap.end(), sourceRow, [&](int a, int b)
+            {
+                return comparator (*list.getUnchecked (a), *list.getUnchecked (b));
+            }) - rowMap.begin());
+        else
+            pos = (int) (std::lower_bound (rowMap.begin(), rowMap.end(), sourceRow) - rowMap.begin());
+        
+        rowMap.insert (pos, sourceRow);
+        inverseValid = false;
+        selection.insertSpace (pos, 1);
+        
+        if (sourceSelection.contains (sourceRow))
+            selection.setSelectionOf (pos, true);
+        
+        sendChange ({ UIListChange::Inserted, Range<int> (pos, pos + 1) });
+    }
+    
+    void sourceRowsRemoved (Range<int> rows)
+    {
+        Array<int> removed;
+        for (int v = rowMap.size(); --v >= 0;)
+        {
+            const int s = rowMap.getUnchecked (v);
+            if (rows.contains (s))
+                removed.add (v);
+            else if (s >= rows.getEnd())
+                rowMap.set (v, s - rows.getLength());
+        }
+        inverseValid = false;
+        removeFromView (removed);
+    }
+    
+    void sourceRowsChanged (Range<int> rows)
+    {
+        const auto& list = source.getList();
+        Range<int> changed;
+        Array<int> misplaced;
+        
+        for (int s = rows.getStart(); s < rows.getEnd(); ++s)
+        {
+            const int v = getViewRow (s);
+            
+            // Filtered in or out by the change?
+            if ((v >= 0) != passes (s))
+            {
+                misplaced.add (s);
+                continue;
+            }
+            
+            if (v < 0)
+                continue;
+            
+            // Still in order with respect to its neighbours?
+            if (isOrdered())
+                if ((v > 0 && comparator (*list.getUnchecked (s), *list.getUnchecked (rowMap.getUnchecked (v - 1))))
+                    || (v < rowMap.size() - 1 && comparator (*list.getUnchecked (rowMap.getUnchecked (v + 1)), *list.getUnchecked (s))))
+                {
+                    misplaced.add (s);
+                    continue;
+                }
+            
+            changed = changed.isEmpty() ? Range<int> (v, v + 1) : changed.getUnionWith (Range<int> (v, v + 1));
+        }
+        
+        if (! changed.isEmpty())
+            sendChange ({ UIListChange::Changed, changed });
+        
+        // Take misplaced rows out and put them back where they belong now
+        Array<int> removed;
+        for (auto s : misplaced)
+        {
+            const int v = getViewRow (s);
+            if (v >= 0)
+                removed.add (v);
+        }
+        
+        std::sort (removed.begin(), removed.end(), std::greater<int>());
+        removeFromView (removed);
+        
+        Array<int> added;
+        for (auto s : misplaced)
+            if (passes (s))
+                added.add (s);
+        
+        insertIntoView (added);
+    }
+    
+    /** Keeps the source selection in step with user selections in view */
+    void ensureValidSelection() override
+    {
+        selection.constrain (rowMap.size());
+        
+        if (selection.isEmpty() && !selection.isNullSelectionEnabled() && !rowMap.isEmpty())
+            selection.set (0);
+        
+        Array<int> sourceRows;
+        for (auto v : selection.getIndexes())
+            sourceRows.add (rowMap.getUnchecked (v));
+        sourceRows.sort();
+        sourceSelection.setMulti (SelectionSet::fromSortedIndexes (sourceRows));
+    }
+    
+    UIListModel<ObjectClass>& source;
+    WeakReference<UIListModelBase> sourceRef;
+    Predicate predicate;
+    Comparator comparator;
+    Array<int> rowMap;
+    Array<int> inverse;
+    bool inverseValid = false;
+    Selection sourceSelection;
+    std::shared_ptr<SortTask> task;
+    int parallelSortThreshold = 20000;
+    uint32 generation = 0;
+    bool sortPending = false;
+    int cancelledSorts = 0;
+    static constexpr int maxCancelledSorts = 3;
+};
+
+
+/**
+ UIPagedListModel is a virtualised list model for huge or remote data sets that can't (or
+ shouldn't) be held in memory entirely. Rather than a list of objects, it is supplied with the
+ total number of rows and a Fetcher, which it asks for rows page by page whenever they are
+ needed for display. Fetching is asynchronous: the fetcher may start a background job, query a
+ database or server, and hand the rows to the Delivery callback later, from any thread.
+ 
+ Fetched pages are kept in a small cache with least-recently-used eviction, and pages around
+ the rows on screen are prefetched, so scrolling rarely hits missing rows. Rows that haven't
+ arrived yet are painted as placeholders. Selections work by row index, as with UIListModel,
+ so the usual GetValue/GetSelection bindings of UIListBox apply unchanged.
+ */
+
+template <typename ObjectClass>
+class UIPagedListModel : public UIListModelBase
+{
+public:
+    
+    using Rows = Array<ObjectClass>;
+    
+    /** Hands over the rows starting at firstRow. May be called on any thread. */
+    using Delivery = std::function<void (int firstRow, const Rows& rows)>;
+    
+    /** Must fetch the requested rows and (eventually) pass them to the delivery */
+    using Fetcher = std::function<void (Range<int> rows, Delivery delivery)>;
+    
+    UIPagedListModel (Fetcher rowFetcher,
+                      int rowsPerPage = 100,
+                      int maxPagesCached = 16,
+                      bool enableMultiSelection = false,
+                      bool enableEmptySelection = true) :
+        UIListModelBase (enableMultiSelection, enableEmptySelection),
+        fetcher (rowFetcher),
+        pageSize (jmax (1, rowsPerPage)),
+        maxPages (jmax (2, maxPagesCached))
+    {}
+    
+   ~UIPagedListModel () {}
+    
+    /** Set the total number of rows. This drops all cached rows, which are fetched again as needed */
+    void setNumRows (int rows)
+    {
+        numRows = jmax (0, rows);
+        refresh();
+    }
+    
+    /** Drop all cached rows, e.g. if the data source has changed */
+    void refresh()
+    {
+        // Deliveries for the previous generation will be ignored
+        generation++;
+        pages.clear();
+        pageIndex.clear();
+        pending.clear();
+        ensureValidSelection();
+        
+        // Views must pick up the number of rows and fetch what they show again
+        views.call ([](auto& view)
+        {
+            view.updateContent();
+            view.repaint();
+        });
+    }
+    
+    /** Whether a row has been fetched and is in the cache */
+    bool isRowAvailable (int row)
+    {
+        return findPage (row / pageSize) != nullptr;
+    }
+    
+    /** Return a pointer to a cached row, or nullptr if it isn't available yet (and request it) */
+    ObjectClass* getRow (int row)
+    {
+        if (row < 0 || row >= numRows)
+            return nullptr;
+        
+        if (auto page = findPage (row / pageSize))
+        {
+            page->lastUsed = ++clock;
+            
+            if (row - page->firstRow < page->rows.size())
+                return &page->rows.getReference (row - page->firstRow);
+            
+            // The fetcher delivered fewer rows than requested, so ask again for the rest
+            if (! page->complete)
+                requestPage (page->index);
+            
+            return nullptr;
+        }
+        
+        requestPage (row / pageSize);
+        return nullptr;
+    }
+    
+    /** Get a pointer to the first selected row, if available */
+    ObjectClass* getSingleSelection()
+    {
+        return getRow (selection.get());
+    }
+    
+    /** Number of pages currently cached */
+    int getNumCachedPages() const { return pages.size(); }
+    
+    int  getNumRows() override { return numRows; }
+    
+    void paintListBoxItem (int rowNumber, Graphics &g, int width, int height, bool rowIsSelected) override
+    {
+        auto& lf = LookAndFeel::getDefaultLookAndFeel();
+        
+        // Opaque rows must fill their background, whether there is something to show or not
+        if (rowIsSelected && rowNumber < numRows)
+            g.fillAll (lf.findColour (TextEditor::highlightColourId));
+        else if (opaqueRows)
+            g.fillAll (lf.findColour (ListBox::backgroundColourId));
+        
+        if (rowNumber >= numRows)
+            return;
+        
+        Font f (height * 0.7f);
+        f.setHorizontalScale (1.0f);
+        g.setFont (f);
+        
+        if (auto row = getRow (rowNumber))
+        {
+            g.setColour (lf.findColour (ListBox::textColourId));
+            g.drawText (PrintHelpers::print (*row), 4, 0, width - 6, height, Justification::centredLeft, true);
+        }
+        else
+        {
+            // Placeholder until the page arrives
+            g.setColour (lf.findColour (ListBox::textColourId).withMultipliedAlpha (0.3f));
+            g.drawText ("...", 4, 0, width - 6, height, Justification::centredLeft, false);
+        }
+    }
+    
+    /** Prefetch pages for the rows on screen, plus one page in either direction */
+    void visibleRowsChanged (Range<int> rows) override
+    {
+        visiblePages = Range<int> (rows.getStart() / pageSize, rows.getEnd() / pageSize + 1);
+        
+        // There is nothing to fetch, and page 0 would be requested as the empty range [0,0)
+        if (numRows == 0)
+            return;
+        
+        const int first = jmax (0, visiblePages.getStart() - 1);
+        const int last  = jmin ((numRows - 1) / pageSize, visiblePages.getEnd());
+        
+        for (int p = first; p <= last; ++p)
+            if (findPage (p) == nullptr)
+                requestPage (p);
+    }
+    
+private:
+    
+    struct Page
+    {
+        int index;
+        int firstRow;
+        uint32 lastUsed;
+        Rows rows;
+        bool complete;
+    };
+    
+    Page* findPage (int index)
+    {
+        return pageIndex[index];
+    }
+    
+    void requestPage (int index)
+    {
+        if (fetcher == nullptr || index < 0 || pending.contains (index))
+            return;
+        
+        pending.add (index);
+        
+        const auto range = Range<int> (index * pageSize, jmin (numRows, (index + 1) * pageSize));
+        const auto requested = generation;
+        WeakReference<UIListModelBase> weakThis (this);
+        
+        fetcher (range, [weakThis, requested] (int firstRow, const Rows& rows)
+        {
+            auto deliver = [weakThis, requested, firstRow, rows]
+            {
+                if (auto model = dynamic_cast<UIPagedListModel*> (weakThis.get()))
+                    model->pageArrived (requested, firstRow, rows);
+            };
+            
+            if (MessageManager::getInstance()->isThisTheMessageThread())
+                deliver();
+            else
+                MessageManager::callAsync (deliver);
+        });
+    }
+    
+    void pageArrived (uint32 requested, int firstRow, const Rows& rows)
+    {
+        if (requested != generation)
+            return;
+        
+        const int index = firstRow / pageSize;
+        pending.removeValue (index);
+        
+        // Only whole pages are cached
+        jassert (firstRow % pageSize == 0);
+        
+        // Nothing to cache, the page is requested again when needed
+        if (rows.isEmpty())
+            return;
+        
+        auto page = findPage (index);
+        if (page == nullptr)
+        {
+            page = pages.add (new Page());
+            pageIndex.set (index, page);
+        }
+        page->index = index;
+        page->firstRow = firstRow;
+        page->rows = rows;
+        page->lastUsed = ++clock;
+        page->complete = rows.size() >= jmin (pageSize, numRows - firstRow);
+        
+        evictPages();
+        
+        const Range<int> arrived (firstRow, firstRow + rows.size());
+        views.call ([arrived](auto& view) { view.repaintRows (arrived); });
+    }
+    
+    void evictPages()
+    {
+        while (pages.size() > maxPages)
+        {
+            Page* oldest = nullptr;
+            
+            for (auto page : pages)
+                if (! visiblePages.contains (page->index))
+                    if (oldest == nullptr || page->lastUsed < oldest->lastUsed)
+                        oldest = page;
+            
+            if (oldest == nullptr)
+                return;
+            
+            pageIndex.remove (oldest->index);
+            pages.removeObject (oldest);
+        }
+    }
+    
+    void ensureValidSelection() override
+    {
+        selection.constrain (numRows);
+        
+        if (selection.isEmpty() && !selection.isNullSelectionEnabled() && numRows > 0)
+            selection.set(0);
+    }
+    
+    Fetcher fetcher;
+    const int pageSize;
+    const int maxPages;
+    int numRows = 0;
+    uint32 generation = 0;
+    uint32 clock = 0;
+    Range<int> visiblePages;
+    OwnedArray<Page> pages;
+    HashMap<int, Page*> pageIndex;
+    SortedSet<int> pending;
 };
 
 }
@@ -18,6 +18,11 @@ void UITreeModelBase::selectionChanged ()
     views.call ([](auto& view) { view.performBinding (Binding::Purpose::SetSelection); });
 }
 
+void UITreeModelBase::rootChanged ()
+{
+    views.call ([](auto& view) { view.rootItemChanged(); });
+}
+
 
 void UITreeItemBase::itemSelectionChanged (bool nowSelected)
 {
@@ -57,21 +62,26 @@ void UITreeView::setComponentState (const Binding::Purpose& p, UITreeModelBase&
     if (p == Binding::Purpose::GetValue)
     {
         treeModel = &contents;
-        setRootItem (treeModel->getRootItem());
+        rootItemChanged();
+        
         // @todo: Issue a warning if mismatched with spec!
         setMultiSelectEnabled (treeModel->getSelection().isMultipleSelectionEnabled());
         treeModel->addView (this);
     }
 }
 
+bool UITreeView::mustNotCull (const Binding::Purpose& p) const
+{
+    return p == Binding::Purpose::GetValue || UIAdaptor::mustNotCull (p);
+}
+
 void UITreeView::getComponentState (const Binding::Purpose& p, Selection& selection)
 {
     if (p == Binding::Purpose::SetSelection)
     {
+        // Kept up to date by itemSelectionChanged(), since asking TreeView walks the entire tree
         selection.clear();
-        for (int i = 0; i < getNumSelectedItems(); ++i)
-            if (auto item = dynamic_cast<UITreeItemBase*> (getSelectedItem (i)))
-                selection.setSelectionOf (item->getIndex(), true);
+        selection.setMulti (shownSelection);
     }
 }
 
@@ -79,19 +89,179 @@ void UITreeView::setComponentState (const Binding::Purpose& p, Selection& select
 {
     if (p == Binding::Purpose::GetSelection)
     {
-        bool clear = true;
-        enumerateTreeItems ([&](auto item)
-        {
-            item->setSelected (selection.contains (item->getIndex()), clear, dontSendNotification);
-            clear = false;
-        });
+        if (treeModel == nullptr)
+            return;
+        
+        // Only touch the items whose state actually changes, which the model finds in constant time
+        const auto& wanted = selection.getIndexes();
+        
+        for (auto index : shownSelection.getDifferenceWith (wanted))
+            if (auto item = treeModel->getItemWithIndex (index))
+                item->setSelected (false, false, dontSendNotification);
+        
+        for (auto index : wanted.getDifferenceWith (shownSelection))
+            if (auto item = treeModel->getItemWithIndex (index))
+                item->setSelected (true, false, dontSendNotification);
+        
+        shownSelection = wanted;
     }
 }
 
+void UITreeView::rootItemChanged ()
+{
+    if (treeModel == nullptr)
+        return;
+    
+    // Lazily expanded trees must open items explicitly, so that their children get created
+    const bool lazy = treeModel->getExpansionPolicy() != UITreeModelBase::ExpansionPolicy::Eager;
+    setDefaultOpenness (! lazy);
+    setRootItem (treeModel->getRootItem());
+    
+    // New items take their selection state from the model
+    shownSelection = treeModel->getSelection().getIndexes();
+    
+    if (lazy && getRootItem() != nullptr)
+        getRootItem()->setOpen (true);
+}
+
 void UITreeView::itemSelectionChanged (UITreeItemBase* selectedItem, bool nowSelected)
 {
+    if (nowSelected)
+        shownSelection.add (selectedItem->getIndex());
+    else
+        shownSelection.remove (selectedItem->getIndex());
+    
     if (nowSelected)
         performBinding (Binding::Purpose::SetSelection);
 }
 
+
+//==========================================================================================================
+#if 0
+#pragma mark UITreeSearchIndex
+#endif
+
+UITreeSearchIndex::UITreeSearchIndex (const Array<Entry>& entriesToIndex) :
+    entries (entriesToIndex)
+{
+    haystacks.ensureStorageAllocated (entries.size());
+    
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries.getReference (i);
+        positions.set (entry.index, i);
+        haystacks.add (entry.text.toLowerCase());
+        
+        for (auto& word : tokenise (haystacks[i]))
+            tokens.add ({ word, i });
+    }
+    
+    std::sort (tokens.begin(), tokens.end(), [](const Token& a, const Token& b)
+    {
+        return a.word < b.word;
+    });
+}
+
+StringArray UITreeSearchIndex::tokenise (const String& text)
+{
+    StringArray words;
+    auto p = text.getCharPointer();
+    
+    while (! p.isEmpty())
+    {
+        while (! p.isEmpty() && ! p.isLetterOrDigit())
+            ++p;
+        
+        auto start = p;
+        while (! p.isEmpty() && p.isLetterOrDigit())
+            ++p;
+        
+        if (p != start)
+            words.add (String (start, p));
+    }
+    words.removeDuplicates (false);
+    return words;
+}
+
+Array<int> UITreeSearchIndex::findPrefix (const String& word) const
+{
+    auto first = std::lower_bound (tokens.begin(), tokens.end(), word, [](const Token& t, const String& w)
+    {
+        return t.word < w;
+    });
+    
+    Array<int> result;
+    for (auto t = first; t != tokens.end() && t->word.startsWith (word); ++t)
+        result.add (t->position);
+    
+    result.sort();
+    
+    // An entry may contain several words with the same prefix
+    Array<int> unique;
+    for (auto position : result)
+        if (unique.isEmpty() || unique.getLast() != position)
+            unique.add (position);
+    
+    return unique;
+}
+
+Array<int> UITreeSearchIndex::find (const String& query, Mode mode, const Array<int>* candidates) const
+{
+    const auto words = tokenise (query.toLowerCase());
+    Array<int> result;
+    
+    if (mode == Mode::Prefix)
+    {
+        bool first = candidates == nullptr;
+        if (! first)
+            result = *candidates;
+        
+        for (auto& word : words)
+        {
+            const auto matches = findPrefix (word);
+            
+            if (first)
+                result = matches;
+            else
+            {
+                // Intersect two ascending lists
+                Array<int> common;
+                int j = 0;
+                for (auto position : result)
+                {
+                    while (j < matches.size() && matches.getUnchecked (j) < position)
+                        ++j;
+                    if (j < matches.size() && matches.getUnchecked (j) == position)
+                        common.add (position);
+                }
+                result.swapWith (common);
+            }
+            first = false;
+        }
+        return result;
+    }
+    
+    auto matchesAll = [&](int position)
+    {
+        for (auto& word : words)
+            if (! haystacks[position].contains (word))
+                return false;
+        return true;
+    };
+    
+    if (candidates != nullptr)
+    {
+        for (auto position : *candidates)
+            if (matchesAll (position))
+                result.add (position);
+    }
+    else
+    {
+        for (int position = 0; position < entries.size(); ++position)
+            if (matchesAll (position))
+                result.add (position);
+    }
+    return result;
+}
+
 }
@@ -16,6 +16,7 @@ namespace ans {
     using namespace juce;
 
 class UITreeView;
+template <typename ObjectClass> class UITreeModel;
 
 /**
  Base class for differently typed tree items, serving the purpose as a common denominator for UIAdaptor API.
@@ -62,91 +63,64 @@ protected:
 };
 
 /**
- UITreeItem is a container for any object to be presented by UITreeModel. UITreeItem requires
- the object to understand UIItemInterface. UITreeItem does NOT take ownership of the object it
- represents, so you must keep it alive while the tree model is operating.  An entire tree is
- owned by its root UITreeItem, so if the root item is deleted, this will delete all children
- recursively. That's why UITreeItem does not own the objects it represents.
+ UITreeSearchIndex answers search queries on a snapshot of a tree. The texts and identifiers of all
+ items are tokenised into a sorted table of words, so prefix queries are binary searches, while
+ substring queries scan a compact array of lower-case strings rather than the tree itself. The
+ index is built on a worker thread by UITreeModel and then used on the message thread.
  */
 
-template <typename ObjectClass>
-class UITreeItem  : public UITreeItemBase
+class UITreeSearchIndex
 {
 public:
-    
-    /** Construct from pointer, if getTreeChildren() provides pointers */
-    UITreeItem (ObjectClass* o, int& ident) :
-        UITreeItemBase (ident++),
-        object (o)
+    enum class Mode
     {
-        for (auto child : object->getItemChildren())
-            if (auto c = dynamic_cast<ObjectClass*>(child))
-                addSubItem (new UITreeItem (c, ident));
-            else {
-                jassertfalse; }
-    }
+        Prefix,         ///< Every word of the query must start a word of the item
+        Substring       ///< Every word of the query must occur anywhere in the item
+    };
     
-    /** Construct from reference, if getTreeChildren() provides references to objects */
-    UITreeItem (ObjectClass& o, int& ident) :
-        UITreeItemBase (ident++),
-        object (&o)
+    /**
+     A tree item in depth-first order, with the index of its parent item (or -1 for the root).
+     Indexes are whatever the caller uses to find the item again, e.g. its position in a snapshot.
+     */
+    struct Entry
     {
-        for (auto child : object->getItemChildren())
-            if (auto c = dynamic_cast<ObjectClass&>(child))
-                addSubItem (new UITreeItem (c, ident));
-            else {
-                jassertfalse; }
-    }
+        int index;
+        int parent;
+        String text;
+    };
     
-    String getUniqueName() const override { return object->getItemIdentifier(); }
+    /** Tokenise and sort the entries. This may take a while, so run it off the message thread. */
+    explicit UITreeSearchIndex (const Array<Entry>& entries);
     
-    void paintItem (Graphics& g, int width, int height) override
-    {
-        if (isSelected())
-            g.fillAll (Colours::lightblue);
-        
-        g.setColour (Colours::white);
-        g.setFont (height * 0.7f);
-        g.drawText (object->getItemString(), 4, 0, width - 4, height, Justification::centredLeft, true);
-    }
+    /**
+     Return the positions of all matching entries in ascending order. If candidates are given,
+     only those are considered, e.g. the matches of a query this one extends.
+     */
+    Array<int> find (const String& query, Mode mode, const Array<int>* candidates = nullptr) const;
     
-    bool mightContainSubItems() override { return object->itemHasChildren(); }
+    int getNumEntries() const { return entries.size(); }
+    const Entry& getEntry (int position) const { return entries.getReference (position); }
     
-    /** Get the object associated with the tree item */
-    ObjectClass* getObject() { return object; }
+    /** Return the position of the entry with an item index, or -1 */
+    int getPosition (int index) const { return positions.contains (index) ? positions[index] : -1; }
     
-    /** Search the tree downwards starting from this item and return the item that bears the given object, or nullptr if none exists */
-    UITreeItem* findItemWithObject (ObjectClass* o)
+private:
+    struct Token
     {
-        if (object == o)
-            return this;
-        
-        for (int i = 0; i < getNumSubItems(); ++i)
-            if (auto found = dynamic_cast<UITreeItem*>(getSubItem(i))->findItemWithObject (o))
-                return found;
-        
-        return nullptr;
-    }
+        String word;
+        int position;
+    };
     
-    /** Search the tree downwards starting from this item and return the item with the given index, or nullptr if none exists */
-    UITreeItem* findItemWithIndex (int indexToLookFor)
-    {
-        if (index == indexToLookFor)
-            return this;
-        
-        for (int i = 0; i < getNumSubItems(); ++i)
-            if (auto found = dynamic_cast<UITreeItem*>(getSubItem(i))->findItemWithIndex (indexToLookFor))
-                return found;
-        
-        return nullptr;
-    }
+    static StringArray tokenise (const String& text);
+    Array<int> findPrefix (const String& word) const;
     
-private:
-    ObjectClass* object;
+    Array<Entry> entries;
+    StringArray haystacks;
+    Array<Token> tokens;
+    HashMap<int, int> positions;
 };
 
 
-
 /**
  UITreeModelBase is base class for differently templated UITreeModel<ObjectClass>
  so they can be passed along and stored uniformly.
@@ -162,22 +136,221 @@ public:
     
     virtual ~UITreeModelBase () {}
     
+    /** When tree items are created for the children of an object */
+    enum class ExpansionPolicy
+    {
+        Eager,          ///< Build the entire tree up front
+        Lazy,           ///< Create children when their parent is opened for the first time
+        LazyRelease     ///< Create children when their parent is opened and delete them when it is closed
+    };
+    
+    /** Set the expansion policy, which takes effect with the next call to setRoot() */
+    void setExpansionPolicy (ExpansionPolicy policy) { expansionPolicy = policy; }
+    
+    ExpansionPolicy getExpansionPolicy() const { return expansionPolicy; }
+    
     void addView (UITreeView* owner) { views.add (owner); }
     void removeView (UITreeView* owner) { views.remove (owner); }
     
     /** Get the item at the root */
     virtual UITreeItemBase* getRootItem() { return nullptr; }
     
+    /** Get the item with an index, or nullptr if there is none (e.g. in a collapsed branch) */
+    virtual UITreeItemBase* getItemWithIndex (int index) { return nullptr; }
+    
 protected:
     void selectionChanged ();
+    
+    /** Have views pick up a different root item, e.g. when switching to or from a filtered tree */
+    void rootChanged ();
+    
     virtual void ensureValidSelection() {}
     
     ListenerList<UITreeView> views;
+    ExpansionPolicy expansionPolicy = ExpansionPolicy::Eager;
     
     JUCE_DECLARE_WEAK_REFERENCEABLE (UITreeModelBase)
 };
 
 
+/**
+ UITreeItem is a container for any object to be presented by UITreeModel. UITreeItem requires
+ the object to understand UIItemInterface. UITreeItem does NOT take ownership of the object it
+ represents, so you must keep it alive while the tree model is operating.  An entire tree is
+ owned by its root UITreeItem, so if the root item is deleted, this will delete all children
+ recursively. That's why UITreeItem does not own the objects it represents.
+ 
+ Depending on the model's ExpansionPolicy, children are created right away or only once the item
+ is opened. Item indexes are assigned by the model per object, so they remain the same if children
+ are released and created again.
+ */
+
+template <typename ObjectClass>
+class UITreeItem  : public UITreeItemBase
+{
+public:
+    
+    UITreeItem (ObjectClass* o, UITreeModel<ObjectClass>& owner) :
+        UITreeItemBase (owner.getIdentityOf (o)),
+        object (o),
+        identifier (o->getItemIdentifier()),
+        model (owner)
+    {
+        model.itemCreated (this);
+        
+        if (model.getExpansionPolicy() == UITreeModelBase::ExpansionPolicy::Eager)
+            materialiseChildren();
+    }
+    
+    /** Tag for items of a filtered tree, which only show the children they are given */
+    struct Detached {};
+    
+    UITreeItem (ObjectClass* o, UITreeModel<ObjectClass>& owner, Detached) :
+        UITreeItemBase (owner.getIdentityOf (o)),
+        object (o),
+        identifier (o->getItemIdentifier()),
+        model (owner),
+        materialised (true),
+        detached (true)
+    {}
+    
+   ~UITreeItem ()
+    {
+        if (! detached)
+            model.itemDeleted (this);
+    }
+    
+    /** Create items for the children of the object, unless that has happened already */
+    void materialiseChildren()
+    {
+        if (materialised)
+            return;
+        
+        materialised = true;
+        
+        for (auto child : object->getItemChildren())
+            if (auto c = dynamic_cast<ObjectClass*>(child))
+            {
+                auto item = new UITreeItem (c, model);
+                item->setSelected (model.getSelection().contains (item->getIndex()), false, dontSendNotification);
+                addSubItem (item);
+            }
+            else {
+                jassertfalse; }
+    }
+    
+    /** Delete the items for the children of the object, which will be created again when needed */
+    void releaseChildren()
+    {
+        clearSubItems();
+        materialised = false;
+    }
+    
+    bool areChildrenMaterialised() const { return materialised; }
+    
+    /**
+     Bring this item and its children in line with an object that has the same identifier, which
+     may or may not be the object represented so far. Children are matched by identifier, so that
+     unchanged items are kept with their index, openness and selection state. Only new children
+     are created and only vanished ones deleted. Previously represented objects are not accessed,
+     so they may have been deleted already.
+     */
+    void refreshFrom (ObjectClass* newObject)
+    {
+        if (newObject != object)
+        {
+            model.rebind (index, object, newObject);
+            object = newObject;
+        }
+        identifier = object->getItemIdentifier();
+        model.visit (index);
+        repaintItem();
+        
+        // Collapsed lazy items will find out when they are opened
+        if (! materialised)
+            return;
+        
+        HashMap<String, UITreeItem*> existing;
+        for (int i = getNumSubItems(); --i >= 0;)
+            if (auto child = dynamic_cast<UITreeItem*> (getSubItem (i)))
+                existing.set (child->identifier, child);
+        
+        int position = 0;
+        for (auto each : object->getItemChildren())
+        {
+            auto c = dynamic_cast<ObjectClass*> (each);
+            if (c == nullptr)
+            {
+                jassertfalse;
+                continue;
+            }
+            
+            const String id = c->getItemIdentifier();
+            
+            if (auto child = existing[id])
+            {
+                existing.remove (id);
+                
+                if (child->getIndexInParent() != position)
+                {
+                    removeSubItem (child->getIndexInParent(), false);
+                    addSubItem (child, position);
+                }
+                child->refreshFrom (c);
+            }
+            else
+            {
+                auto item = new UITreeItem (c, model);
+                item->setSelected (model.getSelection().contains (item->getIndex()), false, dontSendNotification);
+                addSubItem (item, position);
+            }
+            ++position;
+        }
+        
+        // Whatever is left over has vanished from here, though its object may have moved elsewhere,
+        // so the model only lets go of indexes that no item visited after the entire refresh
+        while (getNumSubItems() > position)
+            removeSubItem (getNumSubItems() - 1, true);
+    }
+    
+    void itemOpennessChanged (bool isNowOpen) override
+    {
+        if (detached)
+            return;
+        
+        if (isNowOpen)
+            materialiseChildren();
+        else if (model.getExpansionPolicy() == UITreeModelBase::ExpansionPolicy::LazyRelease)
+            releaseChildren();
+    }
+    
+    String getUniqueName() const override { return identifier; }
+    
+    void paintItem (Graphics& g, int width, int height) override
+    {
+        if (isSelected())
+            g.fillAll (Colours::lightblue);
+        
+        g.setColour (Colours::white);
+        g.setFont (height * 0.7f);
+        g.drawText (object->getItemString(), 4, 0, width - 4, height, Justification::centredLeft, true);
+    }
+    
+    bool mightContainSubItems() override { return detached ? getNumSubItems() > 0 : object->itemHasChildren(); }
+    
+    /** Get the object associated with the tree item */
+    ObjectClass* getObject() { return object; }
+    
+private:
+    ObjectClass* object;
+    String identifier;
+    UITreeModel<ObjectClass>& model;
+    bool materialised = false;
+    bool detached = false;
+};
+
+
+
 /**
  UITreeModel keeps any type of object that implements UIItemInterface. It maintains a selection
  state that UIModel can use to access the currently selected objects. You can derive from this
@@ -199,20 +372,149 @@ public:
             setSingleSelection (initial);
     }
     
-   ~UITreeModel () { masterReference.clear(); }
+   ~UITreeModel ()
+    {
+        masterReference.clear();
+        indexer = nullptr;
+    }
     
     
     /** Replace the entire tree with a new root object */
     void setRoot (ObjectClass* item)
     {
+        clearFilteredTree();
+        invalidateSearchIndex();
+        root = nullptr;
         identCounter = 0;
+        identities.clear();
+        objects.clear();
+        identifiers.clear();
+        items.clear();
+        misses.clear();
+        
         if (item != nullptr)
-            root = std::make_unique<ItemType> (item, identCounter);
-        else
-            root = nullptr;
+        {
+            root = std::make_unique<ItemType> (item, *this);
+            if (expansionPolicy != ExpansionPolicy::Eager)
+                root->materialiseChildren();
+        }
         ensureValidSelection();
     }
     
+    /**
+     Return the index that identifies an object in this tree, assigning a new one if it has none.
+     Indexes remain valid until the next call to setRoot(), or until refresh() finds their object gone.
+     An object at the address of a deleted one is told apart by its identifier.
+     */
+    int getIdentityOf (ObjectClass* o)
+    {
+        const String identifier = o->getItemIdentifier();
+        
+        if (identities.contains (o))
+        {
+            const int ident = identities[o];
+            if (identifiers[ident] == identifier)
+                return ident;
+            
+            drop (ident);
+        }
+        
+        const int ident = identCounter++;
+        identities.set (o, ident);
+        objects.set (ident, o);
+        identifiers.set (ident, identifier);
+        return ident;
+    }
+    
+    /**
+     Update the tree after the object hierarchy has changed, reusing all items whose identifiers
+     are still present (see UIItemInterface::getItemIdentifier()). Unlike setRoot(), this keeps
+     indexes, selection and openness of the remaining items, and views only update what changed.
+     Pass a new root object, if the hierarchy has been recreated, or nullptr to re-read the current one.
+     */
+    void refresh (ObjectClass* newRoot = nullptr)
+    {
+        if (newRoot == nullptr)
+            newRoot = getRoot();
+        
+        if (root == nullptr || newRoot == nullptr || root->getUniqueName() != newRoot->getItemIdentifier())
+            return setRoot (newRoot);
+        
+        // The filtered tree may refer to objects that are gone, so it is rebuilt once re-indexed
+        clearFilteredTree();
+        misses.clear();
+        
+        visited.clearQuick();
+        refreshing = true;
+        root->refreshFrom (newRoot);
+        refreshing = false;
+        dropUnvisited();
+        
+        invalidateSearchIndex();
+        ensureValidSelection();
+    }
+    
+    /**
+     Show only items matching a query, plus their ancestors, or the entire tree again if the query
+     is empty. The search index is built in the background the first time (and after the tree has
+     changed), so the filter may be applied asynchronously. Queries that extend the previous one,
+     as when typing, only re-test the previous matches.
+     */
+    void setSearchQuery (const String& query, UITreeSearchIndex::Mode mode = UITreeSearchIndex::Mode::Prefix)
+    {
+        const bool refine = matchesValid && mode == searchMode && query.trim().startsWith (searchQuery);
+        
+        searchQuery = query.trim();
+        searchMode = mode;
+        matchesValid = refine;
+        
+        if (searchQuery.isEmpty())
+        {
+            matchesValid = false;
+            return clearFilteredTree();
+        }
+        
+        if (searchIndex == nullptr)
+            return startIndexing();
+        
+        applySearch (refine);
+    }
+    
+    const String& getSearchQuery() const { return searchQuery; }
+    
+    /** Whether a filtered tree is shown */
+    bool isFiltered() const { return filteredRoot != nullptr; }
+    
+    /** Whether the search index is being built */
+    bool isIndexing() const { return indexing; }
+    
+    /** Called by UITreeItem when an item now represents a different object with the same identifier */
+    void rebind (int index, ObjectClass* previous, ObjectClass* replacement)
+    {
+        if (identities.contains (previous) && identities[previous] == index)
+            identities.remove (previous);
+        
+        // The replacement may sit at an address that had an index of its own
+        if (identities.contains (replacement) && identities[replacement] != index)
+            drop (identities[replacement]);
+        
+        identities.set (replacement, index);
+        objects.set (index, replacement);
+        identifiers.set (index, replacement->getItemIdentifier());
+    }
+    
+    /** Called by UITreeItem during refresh(), for each index that is still in use */
+    void visit (int index)
+    {
+        if (! refreshing)
+            return;
+        
+        while (visited.size() <= index)
+            visited.add (false);
+        
+        visited.set (index, true);
+    }
+    
     /** Get a pointer to the object at the root of the tree */
     ObjectClass* getRoot()
     {
@@ -222,27 +524,82 @@ public:
             return nullptr;
     }
     
-    UITreeItemBase* getRootItem() override { return root.get(); }
+    UITreeItemBase* getRootItem() override
+    {
+        if (filteredRoot != nullptr)
+            return filteredRoot.get();
+        return root.get();
+    }
+    
+    UITreeItemBase* getItemWithIndex (int index) override { return findItemWithIndex (index); }
+    
+    /** Return the item with an index in constant time (in the filtered tree, if shown), or nullptr if there is none */
+    ItemType* findItemWithIndex (int index) const
+    {
+        if (filteredRoot != nullptr)
+            return filteredItems[index];
+        return items[index];
+    }
+    
+    /** Return the item representing an object in constant time (in the filtered tree, if shown), or nullptr if there is none */
+    ItemType* findItemWithObject (ObjectClass* o) const
+    {
+        return identities.contains (o) ? findItemWithIndex (identities[o]) : nullptr;
+    }
+    
+    /** Called by UITreeItem to keep the index up to date */
+    void itemCreated (ItemType* item)
+    {
+        items.set (item->getIndex(), item);
+        visit (item->getIndex());
+    }
+    
+    /** Called by UITreeItem to keep the index up to date */
+    void itemDeleted (ItemType* item)
+    {
+        // An object that appears more than once may have been registered by another item
+        if (items[item->getIndex()] == item)
+            items.remove (item->getIndex());
+    }
     
-    /** Get the unique index of an object in the tree, or -1 if no such object exists  */
+    /**
+     Get the unique index of an object in the tree, or -1 if no such object exists. Objects in
+     branches that have not been expanded yet are looked up in the object hierarchy.
+     */
     int getIndexOf (ObjectClass* o)
     {
-        if (auto item  = root->findItemWithObject (o))
-            return item->getIndex();
-        else
+        if (o == nullptr || root == nullptr)
             return -1;
+        
+        if (identities.contains (o))
+            return identities[o];
+        
+        // Searching walks the entire hierarchy, so a miss is remembered until the tree changes
+        if (misses.contains (o))
+            return -1;
+        
+        if (findInHierarchy (getRoot(), o))
+            return getIdentityOf (o);
+        
+        misses.set (o, true);
+        return -1;
     }
     
     /** Select or deselect a particular object incrementally */
     void setSelectionOf (ObjectClass* o, bool state)
     {
+        // Objects without an index can't be selected yet, so there is nothing to deselect
+        if (! state && ! identities.contains (o))
+            return;
+        
         selection.setSelectionOf (getIndexOf (o), state);
     }
     
     /** Check whether an object is included with the current selection */
     bool isSelected (ObjectClass* o)
     {
-        return selection.contains (getIndexOf (o));
+        // Only objects with an index can be selected, so there is no need to search for others
+        return identities.contains (o) && selection.contains (identities[o]);
     }
     
     /**
@@ -254,10 +611,7 @@ public:
         if (root == nullptr)
             return nullptr;
         
-        if (auto item  = root->findItemWithIndex (selection.get()))
-            return item->getObject();
-        else
-            return nullptr;
+        return objects[selection.get()];
     }
     
     /** Select one object in the tree */
@@ -267,8 +621,9 @@ public:
             selection.clear();
         else
         {
-            if (auto item = root->findItemWithObject (o))
-                selection.set (item->getIndex());
+            const int index = getIndexOf (o);
+            if (index >= 0)
+                selection.set (index);
             else
             {   // You are selecting an unknown item
                 jassertfalse;
@@ -282,42 +637,290 @@ public:
     {
         Array<ObjectClass*> answer;
         
-        for (auto i : selection.getMulti())
-            answer.add (root->findItemWithIndex (i));
+        for (auto i : selection.getIndexes())
+            if (auto o = objects[i])
+                answer.add (o);
         
         return answer;
     }
     
     /** Select one or more objects in the list */
-    void setMultipleSelection (const Array<ObjectClass*>& objects)
+    void setMultipleSelection (const Array<ObjectClass*>& objectsToSelect)
     {
         Selection newSelection (selection.isMultipleSelectionEnabled(), selection.isNullSelectionEnabled());
         
-        for (auto o : objects)
-            if (auto item = root->findItemWithObject (o))
-                newSelection.setSelectionOf (item->getIndex(), true);
+        for (auto o : objectsToSelect)
+            newSelection.setSelectionOf (getIndexOf (o), true);
         
         setSelection (newSelection);
     }
     
 private:
     
+    /**
+     Walk the hierarchy on the message thread to take the snapshot the worker thread indexes. Entries
+     refer to objects by their position in the snapshot, so only objects that are actually shown by a
+     filtered tree get an index of the model.
+     */
+    void collectEntries (ObjectClass* o, int parent, Array<UITreeSearchIndex::Entry>& entries)
+    {
+        const int position = snapshot.size();
+        snapshot.add (o);
+        entries.add ({ position, parent, o->getItemString() + " " + o->getItemIdentifier() });
+        
+        for (auto child : o->getItemChildren())
+            if (auto c = dynamic_cast<ObjectClass*>(child))
+                collectEntries (c, position, entries);
+    }
+    
+    void startIndexing()
+    {
+        if (indexing || getRoot() == nullptr)
+            return;
+        
+        Array<UITreeSearchIndex::Entry> entries;
+        snapshot.clearQuick();
+        collectEntries (getRoot(), -1, entries);
+        
+        if (indexer == nullptr)
+            indexer = std::make_unique<ThreadPool> (1);
+        
+        indexing = true;
+        const auto generation = indexGeneration;
+        WeakReference<UITreeModelBase> weakThis (this);
+        
+        indexer->addJob ([entries, generation, weakThis]
+        {
+            auto index = std::make_shared<UITreeSearchIndex> (entries);
+            
+            MessageManager::callAsync ([index, generation, weakThis]
+            {
+                if (auto model = dynamic_cast<UITreeModel*> (weakThis.get()))
+                    model->indexArrived (generation, index);
+            });
+        });
+    }
+    
+    void indexArrived (uint32 generation, std::shared_ptr<UITreeSearchIndex> index)
+    {
+        indexing = false;
+        
+        // The tree changed meanwhile
+        if (generation != indexGeneration)
+            return searchQuery.isNotEmpty() ? startIndexing() : void();
+        
+        searchIndex = index;
+        
+        if (searchQuery.isNotEmpty())
+            applySearch (false);
+    }
+    
+    /**
+     Re-indexing walks the entire hierarchy, so after a change it waits for a moment, in case more
+     changes follow (e.g. file system events), and only the last of them has it start.
+     */
+    void invalidateSearchIndex()
+    {
+        ++indexGeneration;
+        searchIndex = nullptr;
+        matchesValid = false;
+        
+        if (searchQuery.isEmpty())
+            return;
+        
+        const auto generation = indexGeneration;
+        WeakReference<UITreeModelBase> weakThis (this);
+        
+        Timer::callAfterDelay (reindexDelayMs, [generation, weakThis]
+        {
+            if (auto model = dynamic_cast<UITreeModel*> (weakThis.get()))
+                if (model->indexGeneration == generation && model->searchQuery.isNotEmpty())
+                    model->startIndexing();
+        });
+    }
+    
+    static constexpr int reindexDelayMs = 250;
+    
+    void applySearch (bool refine)
+    {
+        lastMatches = searchIndex->find (searchQuery, searchMode, refine ? &lastMatches : nullptr);
+        matchesValid = true;
+        
+        // Matches and all their ancestors are shown, which takes time in the number of those, not of all entries
+        HashMap<int, bool> marked;
+        Array<int> shown;
+        
+        for (auto position : lastMatches)
+            for (int p = position; p >= 0 && ! marked.contains (p); p = searchIndex->getPosition (searchIndex->getEntry(p).parent))
+            {
+                marked.set (p, true);
+                shown.add (p);
+            }
+        
+        // Entries are in depth-first order, so parents are created before their children
+        shown.sort();
+        
+        std::unique_ptr<ItemType> newRoot;
+        HashMap<int, ItemType*> newItems;   // by index of the model
+        HashMap<int, ItemType*> created;    // by position in the snapshot
+        
+        for (auto p : shown)
+        {
+            const auto& entry = searchIndex->getEntry (p);
+            auto o = snapshot[entry.index];
+            if (o == nullptr)
+                continue;
+            
+            auto item = new ItemType (o, *this, typename ItemType::Detached());
+            item->setSelected (selection.contains (item->getIndex()), false, dontSendNotification);
+            item->setOpen (true);
+            newItems.set (item->getIndex(), item);
+            created.set (entry.index, item);
+            
+            if (auto parent = created[entry.parent])
+                parent->addSubItem (item);
+            else if (newRoot == nullptr)
+                newRoot.reset (item);
+            else
+                delete item;
+        }
+        
+        // An empty result still shows an (empty) filtered root
+        if (newRoot == nullptr && getRoot() != nullptr)
+            newRoot = std::make_unique<ItemType> (getRoot(), *this, typename ItemType::Detached());
+        
+        // Views must let go of the previous filtered tree before it is deleted
+        auto previous = std::move (filteredRoot);
+        filteredRoot = std::move (newRoot);
+        filteredItems.swapWith (newItems);
+        rootChanged();
+    }
+    
+    void clearFilteredTree()
+    {
+        if (filteredRoot == nullptr)
+            return;
+        
+        auto previous = std::move (filteredRoot);
+        filteredItems.clear();
+        rootChanged();
+    }
+    
+    /** Remove an index along with the object it refers to */
+    void drop (int index)
+    {
+        if (auto o = objects[index])
+            if (identities.contains (o) && identities[o] == index)
+                identities.remove (o);
+        
+        objects.remove (index);
+        identifiers.remove (index);
+    }
+    
+    bool wasVisited (int index) const { return index < visited.size() && visited.getUnchecked (index); }
+    
+    /**
+     After refresh(), drop all indexes that no item visited, as their objects may be gone. Selected
+     objects in collapsed branches are the exception: the hierarchy is searched for them, which stops
+     as soon as all have been found, and only those not found are dropped.
+     */
+    void dropUnvisited()
+    {
+        Array<int> selected;
+        for (auto index : selection.getIndexes())
+            if (! wasVisited (index) && objects.contains (index))
+                selected.add (index);
+        
+        if (! selected.isEmpty() && getRoot() != nullptr)
+        {
+            refreshing = true;
+            visitSelected (getRoot(), selected);
+            refreshing = false;
+        }
+        
+        Array<int> gone;
+        for (typename HashMap<int, ObjectClass*>::Iterator i (objects); i.next();)
+            if (! wasVisited (i.getKey()))
+                gone.add (i.getKey());
+        
+        for (auto index : gone)
+            drop (index);
+    }
+    
+    /** Visit the indexes of selected objects below parent, without touching objects that may be gone */
+    bool visitSelected (ObjectClass* parent, Array<int>& selected)
+    {
+        for (auto child : parent->getItemChildren())
+            if (auto c = dynamic_cast<ObjectClass*>(child))
+            {
+                if (identities.contains (c))
+                {
+                    const int index = identities[c];
+                    
+                    if (selected.contains (index) && identifiers[index] == c->getItemIdentifier())
+                    {
+                        visit (index);
+                        selected.removeFirstMatchingValue (index);
+                        
+                        if (selected.isEmpty())
+                            return true;
+                    }
+                }
+                if (visitSelected (c, selected))
+                    return true;
+            }
+        return false;
+    }
+    
+    /** Walk the objects below parent, assigning indexes, until target is found */
+    /** Objects passed on the way don't get an index, only the target does, once found */
+    bool findInHierarchy (ObjectClass* parent, ObjectClass* target)
+    {
+        for (auto child : parent->getItemChildren())
+            if (auto c = dynamic_cast<ObjectClass*>(child))
+                if (c == target || findInHierarchy (c, target))
+                    return true;
+        
+        return false;
+    }
+    
     void ensureValidSelection() override
     {
         if (root == nullptr)
             return selection.clear();
         
+        // Indexes of objects in collapsed branches remain valid
         Selection::Set previous = selection.getMulti();
         for (auto index : previous)
-            if (index < 0 || root->findItemWithIndex (index) == nullptr)
+            if (! objects.contains (index))
                 selection.setSelectionOf (index, false);
         
         if (selection.get() == -1 && !selection.isNullSelectionEnabled())
             selection.set(0); // root
     }
     
+    // The maps must outlive root, as items unregister when deleted
+    HashMap<ObjectClass*, int> identities;
+    HashMap<int, ObjectClass*> objects;
+    HashMap<int, String> identifiers;       // of the objects, to tell a new object at a reused address
+    HashMap<int, ItemType*> items;
+    HashMap<ObjectClass*, bool> misses;     // objects searched for in vain since the tree last changed
+    HashMap<int, ItemType*> filteredItems;
     std::unique_ptr<ItemType> root;
+    std::unique_ptr<ItemType> filteredRoot;
     int identCounter;
+    Array<bool> visited;                    // by index, during refresh()
+    bool refreshing = false;
+    
+    String searchQuery;
+    UITreeSearchIndex::Mode searchMode = UITreeSearchIndex::Mode::Prefix;
+    std::shared_ptr<UITreeSearchIndex> searchIndex;
+    Array<ObjectClass*> snapshot;           // objects of the search index by position
+    Array<int> lastMatches;
+    bool matchesValid = false;
+    std::unique_ptr<ThreadPool> indexer;
+    uint32 indexGeneration = 0;
+    bool indexing = false;
     
     JUCE_LEAK_DETECTOR (UITreeModel)
 };
@@ -339,6 +942,13 @@ public:
     
     void itemSelectionChanged (UITreeItemBase* selectedItem, bool nowSelected);
     
+    /** Show the model's current root item, e.g. after it switched to or from a filtered tree */
+    void rootItemChanged();
+    
+protected:
+    /** TreeView keeps a raw pointer to the model's root item, which must follow the model even while hidden */
+    bool mustNotCull (const Binding::Purpose& p) const override;
+    
 private:
     template <typename LAMBDA>
     void enumerateTreeItems (LAMBDA&& each)
@@ -348,6 +958,7 @@ private:
     }
     
     WeakReference<UITreeModelBase> treeModel;
+    Selection::Set shownSelection;  // Indexes of the items selected in view
 };
 
 
@@ -38,7 +38,7 @@ public:
 
     void setComponentState (const Binding::Purpose& p, const String& value) override { setTextToDisplay (value); }
     void getComponentState (const Binding::Purpose& p, double& value) override { value = progress; }
-    void setComponentState (const Binding::Purpose& p, double  value) override { progress = value; repaint(); }
+    void setComponentState (const Binding::Purpose& p, double  value) override { progress = value; repaintComponent(); }
     
 private:
     double progress;
@@ -250,7 +250,7 @@ public:
     void sliderValueChanged (Slider* slider) override   { performBinding (Binding::Purpose::SetValue); }
     
     void getComponentState (const Binding::Purpose& p, double& value) override { value = Slider::getValue(); }
-    void setComponentState (const Binding::Purpose& p, double  value) override { Slider::setValue (value); repaint(); }
+    void setComponentState (const Binding::Purpose& p, double  value) override { Slider::setValue (value); repaintComponent(); }
 };
 
 
@@ -10,6 +10,7 @@
 #include "ans_adaptor_window.h"
 #include "ans_adaptor_composite.h"
 #include "../core/ans_UIModel.h"
+#include "../utility/ans_LayoutScheduler.h"
 
 
 namespace ans {
@@ -95,9 +96,12 @@ void UIDocumentWindow::resized()
 {
     DocumentWindow::resized();
     
+    // Lay out right away, so the window never shows stale content
     if (auto content = getContentComponent())
-        if (auto positioner = content->getPositioner())
-            positioner->applyNewBounds (getBounds());
+    {
+        LayoutScheduler::getInstance()->markDirty (*content);
+        LayoutScheduler::getInstance()->flush();
+    }
 }
 
 void UIDocumentWindow::closeButtonPressed ()
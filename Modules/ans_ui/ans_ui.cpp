@@ -5,8 +5,14 @@
 
 #include "JuceHeader.h"
 
+#include "utility/ans_UIArena.cpp"
+#include "utility/ans_LayoutScheduler.cpp"
 #include "utility/ans_LayoutFrame.cpp"
+#include "utility/ans_LayoutFrameBatch.cpp"
+#include "utility/ans_AnchorSolver.cpp"
 #include "utility/ans_LayoutCursor.cpp"
+#include "utility/ans_RenderCache.cpp"
+#include "utility/ans_RepaintBatcher.cpp"
 
 #include "core/ans_Binding.cpp"
 #include "adaptors/ans_adaptor_base.cpp"
@@ -43,6 +43,41 @@
 #define ANS_INCLUDE_NAMESPACE 1
 #endif
 
+/** Config: ANS_USE_BUILD_ARENA
+    Allocate bindings and positioners of a UIInstance from an arena that is released in bulk, rather than individually from the heap
+ */
+#ifndef ANS_USE_BUILD_ARENA
+#define ANS_USE_BUILD_ARENA 1
+#endif
+
+/** Config: ANS_MEMOISE_LAYOUT
+    Have each FramePositioner remember the rectangles of its children for the last few sizes it was laid out at
+ */
+#ifndef ANS_MEMOISE_LAYOUT
+#define ANS_MEMOISE_LAYOUT 1
+#endif
+
+/** Config: ANS_RENDER_CACHE_IDLE_FRAMES
+    Number of frames (at 30 per second) that the bindings of a component with RenderCache::Policy::Auto must stay idle, before its rendering is cached
+ */
+#ifndef ANS_RENDER_CACHE_IDLE_FRAMES
+#define ANS_RENDER_CACHE_IDLE_FRAMES 30
+#endif
+
+/** Config: ANS_BATCH_REPAINTS
+    Merge the repaints that adaptors request while updating and issue them once at the end of the message callback
+ */
+#ifndef ANS_BATCH_REPAINTS
+#define ANS_BATCH_REPAINTS 1
+#endif
+
+/** Config: ANS_CULL_HIDDEN_UPDATES
+    Have adaptors that aren't on screen remember the aspects they are updated for, and perform their bindings once they become visible
+ */
+#ifndef ANS_CULL_HIDDEN_UPDATES
+#define ANS_CULL_HIDDEN_UPDATES 1
+#endif
+
 using namespace juce;
 
 #ifndef ANS_PROJECT_DIR
@@ -52,8 +87,14 @@ using namespace juce;
 // Linux: ???
 #endif
 
+#include "utility/ans_UIArena.h"
+#include "utility/ans_LayoutScheduler.h"
 #include "utility/ans_LayoutFrame.h"
+#include "utility/ans_LayoutFrameBatch.h"
+#include "utility/ans_AnchorSolver.h"
 #include "utility/ans_LayoutCursor.h"
+#include "utility/ans_RenderCache.h"
+#include "utility/ans_RepaintBatcher.h"
 #include "utility/ans_Positioners.h"
 #include "utility/ans_SourceOutputStream.h"
 #include "utility/ans_Tools.h"
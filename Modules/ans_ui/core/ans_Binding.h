@@ -10,6 +10,7 @@
 #pragma once
 
 #include "../utility/ans_SourceOutputStream.h"
+#include "../utility/ans_UIArena.h"
 
 namespace ans {
     using namespace juce;
@@ -63,7 +64,7 @@ private:
  container and respond to a uniform protocol.
  */
 
-class Binding
+class Binding : public UIArena::Allocated
 {
 public:
     
@@ -14,6 +14,371 @@
 namespace ans {
     using namespace juce;
 
+/**
+ SelectionSet is a set of indexes stored as sorted, disjoint runs. Selecting all rows of a list or a
+ shift-clicked range is a single run, regardless of how many indexes it covers. Lookups use a binary
+ search over the runs, set operations merge the runs linearly.
+ 
+ Copies share their runs until one of them is modified (copy-on-write), so passing selections
+ around by value is cheap. getRanges() provides the runs as a SparseSet<int>, as expected by
+ ListBox::setSelectedRows(); it is built once and shared by all copies.
+ */
+
+class SelectionSet
+{
+public:
+    
+    SelectionSet () {}
+    
+    explicit SelectionSet (Range<int> range) { addRange (range); }
+    
+    /** Create from an ascending list of indexes, e.g. as collected from a list of objects */
+    static SelectionSet fromSortedIndexes (const Array<int>& indexes)
+    {
+        SelectionSet answer;
+        for (auto i : indexes)
+            answer.add (i);
+        return answer;
+    }
+    
+    /** Create from the selected rows of a ListBox */
+    static SelectionSet fromRanges (const SparseSet<int>& ranges)
+    {
+        SelectionSet answer;
+        for (int i = 0; i < ranges.getNumRanges(); ++i)
+            answer.addRange (ranges.getRange (i));
+        return answer;
+    }
+    
+    /** Return the number of indexes (not runs) in the set */
+    int size () const noexcept              { return data != nullptr ? data->count : 0; }
+    bool isEmpty () const noexcept          { return size() == 0; }
+    
+    int getNumRanges () const noexcept      { return data != nullptr ? data->runs.size() : 0; }
+    Range<int> getRange (int i) const       { return data != nullptr ? data->runs[i] : Range<int>(); }
+    
+    /** Return the lowest index, or -1 if empty */
+    int getFirst () const                   { return isEmpty() ? -1 : data->runs.getFirst().getStart(); }
+    
+    /** Return the highest index, or -1 if empty */
+    int getLast () const                    { return isEmpty() ? -1 : data->runs.getLast().getEnd() - 1; }
+    
+    bool contains (int index) const
+    {
+        const int i = findRunEndingAfter (index);
+        return i < getNumRanges() && data->runs.getReference(i).contains (index);
+    }
+    
+    bool containsRange (Range<int> range) const
+    {
+        const int i = findRunEndingAfter (range.getStart());
+        return i < getNumRanges() && data->runs.getReference(i).contains (range);
+    }
+    
+    bool overlapsRange (Range<int> range) const
+    {
+        const int i = findRunEndingAfter (range.getStart());
+        return i < getNumRanges() && data->runs.getReference(i).intersects (range);
+    }
+    
+    void add (int index)     { addRange (Range<int> (index, index + 1)); }
+    void remove (int index)  { removeRange (Range<int> (index, index + 1)); }
+    
+    void addRange (Range<int> range)
+    {
+        if (range.isEmpty() || containsRange (range))
+            return;
+        
+        auto& d = modify();
+        
+        // Merge with all runs that overlap or touch the new one
+        int i = 0, hi = d.runs.size();
+        while (i < hi)
+        {
+            const int mid = (i + hi) / 2;
+            if (d.runs.getReference(mid).getEnd() < range.getStart()) i = mid + 1; else hi = mid;
+        }
+        
+        int j = i;
+        while (j < d.runs.size() && d.runs.getReference(j).getStart() <= range.getEnd())
+        {
+            d.count -= d.runs.getReference(j).getLength();
+            range = range.getUnionWith (d.runs.getReference(j));
+            ++j;
+        }
+        d.runs.removeRange (i, j - i);
+        d.runs.insert (i, range);
+        d.count += range.getLength();
+    }
+    
+    void removeRange (Range<int> range)
+    {
+        if (range.isEmpty() || ! overlapsRange (range))
+            return;
+        
+        auto& d = modify();
+        int i = findRunEndingAfter (range.getStart());
+        
+        while (i < d.runs.size() && d.runs.getReference(i).getStart() < range.getEnd())
+        {
+            const auto run = d.runs.getReference(i);
+            const bool keepBefore = run.getStart() < range.getStart();
+            const bool keepAfter = run.getEnd() > range.getEnd();
+            d.count -= run.getIntersectionWith (range).getLength();
+            
+            if (keepBefore && keepAfter)
+            {
+                d.runs.set (i, Range<int> (run.getStart(), range.getStart()));
+                d.runs.insert (i + 1, Range<int> (range.getEnd(), run.getEnd()));
+                break;
+            }
+            if (keepAfter)
+            {
+                d.runs.set (i, Range<int> (range.getEnd(), run.getEnd()));
+                break;
+            }
+            if (keepBefore)
+                d.runs.set (i++, Range<int> (run.getStart(), range.getStart()));
+            else
+                d.runs.remove (i);
+        }
+    }
+    
+    void clear ()
+    {
+        data = nullptr;
+    }
+    
+    /** Shift all indexes >= index up by count, e.g. after as many rows were inserted at index */
+    void insertSpace (int index, int count)
+    {
+        if (count <= 0 || getLast() < index)
+            return;
+        
+        auto& d = modify();
+        int i = findRunEndingAfter (index);
+        
+        // Split a run that straddles the insertion point
+        if (d.runs.getReference(i).getStart() < index)
+        {
+            const auto run = d.runs.getReference(i);
+            d.runs.set (i, Range<int> (run.getStart(), index));
+            d.runs.insert (++i, Range<int> (index, run.getEnd()));
+        }
+        
+        for (; i < d.runs.size(); ++i)
+            d.runs.getReference(i) += count;
+    }
+    
+    /** Remove a range of indexes and shift all indexes above it down, e.g. after these rows were removed */
+    void removeSpace (Range<int> range)
+    {
+        if (range.isEmpty() || getLast() < range.getStart())
+            return;
+        
+        removeRange (range);
+        
+        auto& d = modify();
+        const int i = findRunEndingAfter (range.getStart());
+        
+        for (int k = i; k < d.runs.size(); ++k)
+            d.runs.getReference(k) -= range.getLength();
+        
+        // Runs on either side of the gap may now touch
+        if (i > 0 && i < d.runs.size() && d.runs.getReference(i - 1).getEnd() == d.runs.getReference(i).getStart())
+        {
+            d.runs.set (i - 1, d.runs.getReference(i - 1).getUnionWith (d.runs.getReference(i)));
+            d.runs.remove (i);
+        }
+    }
+    
+    /** Return all indexes in this or the other set */
+    SelectionSet getUnionWith (const SelectionSet& other) const
+    {
+        if (other.isEmpty()) return *this;
+        if (isEmpty()) return other;
+        
+        Array<Range<int>> out;
+        const auto& a = data->runs;
+        const auto& b = other.data->runs;
+        int i = 0, j = 0;
+        
+        while (i < a.size() || j < b.size())
+        {
+            const auto next = (j >= b.size() || (i < a.size() && a.getReference(i).getStart() <= b.getReference(j).getStart()))
+                ? a.getReference(i++)
+                : b.getReference(j++);
+            
+            if (! out.isEmpty() && out.getReference (out.size() - 1).getEnd() >= next.getStart())
+                out.getReference (out.size() - 1) = out.getLast().getUnionWith (next);
+            else
+                out.add (next);
+        }
+        return SelectionSet (out);
+    }
+    
+    /** Return the indexes in both this and the other set */
+    SelectionSet getIntersectionWith (const SelectionSet& other) const
+    {
+        if (isEmpty() || other.isEmpty())
+            return {};
+        
+        Array<Range<int>> out;
+        const auto& a = data->runs;
+        const auto& b = other.data->runs;
+        int i = 0, j = 0;
+        
+        while (i < a.size() && j < b.size())
+        {
+            const auto common = a.getReference(i).getIntersectionWith (b.getReference(j));
+            if (! common.isEmpty())
+                out.add (common);
+            
+            if (a.getReference(i).getEnd() < b.getReference(j).getEnd()) ++i; else ++j;
+        }
+        return SelectionSet (out);
+    }
+    
+    /** Return the indexes in this set that are not in the other */
+    SelectionSet getDifferenceWith (const SelectionSet& other) const
+    {
+        if (isEmpty() || other.isEmpty())
+            return *this;
+        
+        Array<Range<int>> out;
+        const auto& b = other.data->runs;
+        int j = 0;
+        
+        for (auto run : data->runs)
+        {
+            while (j < b.size() && b.getReference(j).getEnd() <= run.getStart())
+                ++j;
+            
+            for (int k = j; k < b.size() && b.getReference(k).getStart() < run.getEnd(); ++k)
+            {
+                const auto& cut = b.getReference(k);
+                if (cut.getStart() > run.getStart())
+                    out.add (Range<int> (run.getStart(), cut.getStart()));
+                run.setStart (jmin (run.getEnd(), cut.getEnd()));
+            }
+            if (! run.isEmpty())
+                out.add (run);
+        }
+        return SelectionSet (out);
+    }
+    
+    /** Return the runs in the form ListBox expects. The reference remains valid until this set is modified */
+    const SparseSet<int>& getRanges () const
+    {
+        static const SparseSet<int> empty;
+        if (data == nullptr)
+            return empty;
+        
+        if (data->sparse == nullptr)
+        {
+            data->sparse = std::make_unique<SparseSet<int>>();
+            for (auto& run : data->runs)
+                data->sparse->addRange (run);
+        }
+        return *data->sparse;
+    }
+    
+    bool operator== (const SelectionSet& other) const
+    {
+        return data == other.data
+            || (size() == other.size() && getNumRanges() == other.getNumRanges()
+                && (isEmpty() || data->runs == other.data->runs));
+    }
+    
+    bool operator!= (const SelectionSet& other) const { return ! operator== (other); }
+    
+    /** Iterates over all indexes in ascending order */
+    struct Iterator
+    {
+        const Range<int>* run;
+        const Range<int>* end;
+        int value;
+        
+        int operator* () const { return value; }
+        
+        Iterator& operator++ ()
+        {
+            if (++value >= run->getEnd() && ++run != end)
+                value = run->getStart();
+            return *this;
+        }
+        
+        bool operator!= (const Iterator& other) const
+        {
+            return run != other.run || (run != end && value != other.value);
+        }
+    };
+    
+    Iterator begin () const
+    {
+        if (isEmpty())
+            return end();
+        return { data->runs.begin(), data->runs.end(), data->runs.getFirst().getStart() };
+    }
+    
+    Iterator end () const
+    {
+        auto last = isEmpty() ? nullptr : data->runs.end();
+        return { last, last, 0 };
+    }
+    
+private:
+    
+    struct Data
+    {
+        Data () {}
+        Data (const Array<Range<int>>& r, int c) : runs (r), count (c) {}
+        
+        Array<Range<int>> runs;
+        int count = 0;
+        mutable std::unique_ptr<SparseSet<int>> sparse;
+    };
+    
+    /** Takes sorted, disjoint runs as produced by the set operations */
+    explicit SelectionSet (const Array<Range<int>>& runs)
+    {
+        if (runs.isEmpty())
+            return;
+        
+        int count = 0;
+        for (auto& run : runs)
+            count += run.getLength();
+        data = std::make_shared<Data> (runs, count);
+    }
+    
+    /** Index of the first run that ends after index, or getNumRanges() if there is none */
+    int findRunEndingAfter (int index) const
+    {
+        int lo = 0, hi = getNumRanges();
+        while (lo < hi)
+        {
+            const int mid = (lo + hi) / 2;
+            if (data->runs.getReference(mid).getEnd() <= index) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+    
+    /** Detach from other copies before modifying */
+    Data& modify ()
+    {
+        if (data == nullptr)
+            data = std::make_shared<Data>();
+        else if (data.use_count() > 1)
+            data = std::make_shared<Data> (data->runs, data->count);
+        
+        data->sparse = nullptr;
+        return *data;
+    }
+    
+    std::shared_ptr<Data> data;
+};
+
+
 /**
  Selection manages a multiple or single selection of objects, by keeping a set of indexes
  identifying those. It is the responsibility of its owner to map those indexes to actual
@@ -27,7 +392,7 @@ class Selection
 {
 public:
     
-    using Set = SortedSet<int>;
+    using Set = SelectionSet;
     
     Selection (bool multi = true, bool mayBeEmpty = true, int initial = -1) :
         enableMultipleSelection (multi),
@@ -112,11 +477,34 @@ public:
         changed = true;
     }
     
-    /** Get a copy of all currently selected indexes */
+    /** Get a copy of all currently selected indexes. This is cheap, as copies share their contents */
     Set getMulti() const
     {
         return selected;
     }
+    
+    /** Get a reference to all currently selected indexes */
+    const Set& getIndexes() const
+    {
+        return selected;
+    }
+    
+    /**
+     Select a range of indexes in one go, e.g. for select-all or shift-click. In a single selection,
+     this selects the start of the range only.
+     */
+    void selectRange (Range<int> range, bool deselectOthers = true)
+    {
+        if (range.isEmpty() || range.getStart() < 0)
+            return;
+        
+        if (!enableMultipleSelection)
+            return set (range.getStart());
+        
+        Set newSelection = deselectOthers ? Set() : selected;
+        newSelection.addRange (range);
+        setMulti (newSelection);
+    }
 
     /** Set multiple indexes in one go */
     void setMulti (const Set& indexes)
@@ -131,13 +519,53 @@ public:
     /** Remove all selected indexes >= max. This may end up with an empty selection, even if not allowed! */
     void constrain (int max)
     {
-        Set copy = selected;
-        for (auto i : copy)
-            if (i >= max)
-            {
-                selected.remove(i);
-                changed = true;
-            }
+        if (selected.getLast() < max)
+            return;
+        
+        selected.removeRange (Range<int> (jmax (0, max), std::numeric_limits<int>::max()));
+        changed = true;
+    }
+    
+    /** Shift selected indexes >= index up by count, after as many items were inserted at index */
+    void insertSpace (int index, int count)
+    {
+        if (count <= 0 || selected.getLast() < index)
+            return;
+        
+        selected.insertSpace (index, count);
+        changed = true;
+    }
+    
+    /** Deselect a range of indexes and shift those above it down, after these items were removed */
+    void removeSpace (Range<int> range)
+    {
+        if (range.isEmpty() || selected.getLast() < range.getStart())
+            return;
+        
+        selected.removeSpace (range);
+        changed = true;
+    }
+    
+    /**
+     Follow items that were moved as a block, so that destination is the new index of the
+     first moved item after the move
+     */
+    void moveSpace (Range<int> range, int destination)
+    {
+        if (range.isEmpty() || destination == range.getStart())
+            return;
+        
+        const Set previous = selected;
+        const Set moved = selected.getIntersectionWith (Set (range));
+        
+        selected.removeSpace (range);
+        selected.insertSpace (destination, range.getLength());
+        
+        for (int i = 0; i < moved.getNumRanges(); ++i)
+            selected.addRange (moved.getRange(i) + (destination - range.getStart()));
+        
+        if (selected != previous)
+            changed = true;
     }
     
     /** Whether the selection has changed since the last call to hasChanged(). Every call resets this status */
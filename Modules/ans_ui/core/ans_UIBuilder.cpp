@@ -47,13 +47,20 @@ std::unique_ptr<TopLevelWindow> UIBuilder::buildWindow (UISpec* spec, WindowUIMo
     
     /** @todo respect other window types */
     auto owner  = std::make_shared<UIInstance> (model, spec);
-    auto window = std::make_unique<UIDocumentWindow> (owner, *windowSpec);
-    
-    if (auto contentSpec = windowSpec->children.getFirst())
-        window->addComponent (buildComponent (contentSpec, owner, nullptr));
+    std::unique_ptr<UIDocumentWindow> window;
+    {
+        UIArena::Scope arena (owner->getArena());
+        {
+            // The window survives UIInstance::clear(), so its block would keep the arena from resetting
+            UIArena::Scope heap (nullptr);
+            window = std::make_unique<UIDocumentWindow> (owner, *windowSpec);
+        }
+        
+        if (auto contentSpec = windowSpec->children.getFirst())
+            window->addComponent (buildComponent (contentSpec, owner, nullptr));
+    }
 
     model->postBuild (*owner);
-    model->changed (Model::Undefined);
     
     auto screen = Desktop::getInstance().getDisplays().getMainDisplay().userArea;
     auto area = windowSpec->layout.frame.rectangleRelativeTo (screen);
@@ -77,11 +84,15 @@ bool UIBuilder::buildInto (UISpec* spec, UIModel* model, UIComposite* composite)
     composite->componentBuildBegin();
     auto instance = composite->getUIInstance()->getChildInstanceFor (model, spec);
     instance->clear();
-    
-    for (auto childSpec : componentSpec->children)
-        composite->addComponent (buildComponent (childSpec, instance, composite));
-    
-    buildEditLink (instance, composite);
+    {
+        UIArena::Scope arena (instance->getArena());
+        checkAnchors (componentSpec);
+        
+        for (auto childSpec : componentSpec->children)
+            composite->addComponent (buildComponent (childSpec, instance, composite));
+        
+        buildEditLink (instance, composite);
+    }
     composite->componentBuildEnd();
     
     model->postBuild (*instance);
@@ -102,6 +113,11 @@ std::unique_ptr<Component> UIBuilder::buildComponent (const ComponentSpec* spec,
         parent->addAndMakeVisible (comp.get());
     
     auto adaptor = dynamic_cast<UIAdaptor*> (comp.get());
+    checkAnchors (spec);
+    
+    if (spec->buildsChildrenOnDemand())
+        return comp;
+    
     for (auto childSpec : spec->children)
     {
         if (adaptor != nullptr)
@@ -132,10 +148,12 @@ bool UIBuilder::buildProxyInto (UISpec* spec,
     composite->componentBuildBegin();
     auto instance = composite->getUIInstance()->getChildInstanceFor (model, spec);
     instance->clear();
-    
-    for (auto childSpec : componentSpec->children)
-        composite->addComponent (buildProxy (childSpec, instance, composite, mockups));
-    
+    {
+        UIArena::Scope arena (instance->getArena());
+        
+        for (auto childSpec : componentSpec->children)
+            composite->addComponent (buildProxy (childSpec, instance, composite, mockups));
+    }
     composite->componentBuildEnd();
     model->postBuild (*instance);
     return true;
@@ -177,21 +195,51 @@ bool UIBuilder::buildEmptyCanvas (UIComposite* composite)
 }
 
 
+bool UIBuilder::checkAnchors (const ComponentSpec* spec)
+{
+    Array<std::pair<SymbolID, LayoutFrame>> siblings;
+    bool anchored = false;
+    
+    for (auto child : spec->children)
+        if (child->layout.type == LayoutSpec::Frame)
+        {
+            siblings.add ({ child->key, child->layout.frame });
+            anchored = anchored || child->layout.frame.hasAnchors();
+        }
+    
+    if (! anchored)
+        return true;
+    
+    String problem;
+    if (AnchorSolver::validate (siblings, problem))
+        return true;
+    
+    DBG ("*** ERROR: Layout of children of " << spec->identifier.quoted() << ": " << problem);
+    jassertfalse;
+    return false;
+}
+
 void UIBuilder::buildEditLink (std::shared_ptr<UIInstance> instance, UIComposite* composite)
 {
     if (instance->getModel()->hasUIEditorLink())
     {
 #if JUCE_DEBUG
-        std::unique_ptr<ButtonSpec> button1 = std::make_unique<ButtonSpec> ("openCloneButton");
-        button1->setLabel ("clone");
-        button1->setLayout ((LayoutFrame("100% - 88", "4", "0", "0").withFixedWidth(40).withFixedHeight(16)));
-        button1->addBinding (Bind::Action (MEMBER(&UIModel::openClone)));
+        std::unique_ptr<ButtonSpec> button1, button2;
+        {
+            // Spec bindings belong to the specs, not to the instance whose arena is in scope
+            UIArena::Scope heap (nullptr);
+            
+            button1 = std::make_unique<ButtonSpec> ("openCloneButton");
+            button1->setLabel ("clone");
+            button1->setLayout (LayoutFrame ("100% - 88"_side, "4"_side, "40 relative"_side, "16 relative"_side));
+            button1->addBinding (Bind::Action (MEMBER(&UIModel::openClone)));
+            
+            button2 = std::make_unique<ButtonSpec> ("openUIEditorButton");
+            button2->setLabel ("edit");
+            button2->setLayout (LayoutFrame ("100% - 44"_side, "4"_side, "40 relative"_side, "16 relative"_side));
+            button2->addBinding (Bind::Action (MEMBER(&UIModel::openUIEditor)));
+        }
         composite->addComponent (button1->buildInstance (instance));
-        
-        std::unique_ptr<ButtonSpec> button2 = std::make_unique<ButtonSpec> ("openUIEditorButton");
-        button2->setLabel ("edit");
-        button2->setLayout ((LayoutFrame("100% - 44", "4", "0", "0").withFixedWidth(40).withFixedHeight(16)));
-        button2->addBinding (Bind::Action (MEMBER(&UIModel::openUIEditor)));
         composite->addComponent (button2->buildInstance (instance));
 #endif
     }
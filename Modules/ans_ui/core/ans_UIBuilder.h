@@ -56,6 +56,9 @@ struct UIBuilder
     
     /** Adds the 'edit' link to UIs (development builds only) */
     static void buildEditLink (std::shared_ptr<UIInstance> instance, UIComposite* composite);
+    
+    /** Check that the children of a spec don't anchor to unknown siblings or form cycles */
+    static bool checkAnchors (const ComponentSpec* spec);
 
 };
 
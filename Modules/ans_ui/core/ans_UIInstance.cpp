@@ -19,6 +19,38 @@ namespace ans
 #pragma mark UIInstance
 #endif
 
+/**
+ Flat index of all adaptors registered with any instance of the same hierarchy. Identifiers are
+ only unique per instance, so each key maps to all adaptors registered under it.
+ */
+
+struct UIInstance::HierarchyIndex
+{
+    void add (SymbolID key, UIAdaptor* adaptor)
+    {
+        adaptors[key].addIfNotAlreadyThere (adaptor);
+    }
+    
+    void remove (SymbolID key, UIAdaptor* adaptor)
+    {
+        auto found = adaptors.find (key);
+        if (found == adaptors.end())
+            return;
+        
+        found->second.removeFirstMatchingValue (adaptor);
+        if (found->second.isEmpty())
+            adaptors.erase (found);
+    }
+    
+    const Array<UIAdaptor*>* find (SymbolID key) const
+    {
+        auto found = adaptors.find (key);
+        return found != adaptors.end() ? &found->second : nullptr;
+    }
+    
+    std::unordered_map<SymbolID, Array<UIAdaptor*>> adaptors;
+};
+
 UIInstance::UIInstance (UIModel* uiModel, UISpec* uiSpec, std::shared_ptr<UIInstance> parentInstance, bool forMockup) :
     parent (parentInstance),
     spec (uiSpec),
@@ -26,6 +58,15 @@ UIInstance::UIInstance (UIModel* uiModel, UISpec* uiSpec, std::shared_ptr<UIInst
     registry (),
     mockup (forMockup)
 {
+   #if ANS_USE_BUILD_ARENA
+    arena.reset (new UIArena());
+   #endif
+    
+    // Mockups must not be found by lookups in the real hierarchy
+    if (parentInstance != nullptr && ! forMockup)
+        hierarchy = parentInstance->hierarchy;
+    else
+        hierarchy = std::make_shared<HierarchyIndex>();
 }
 
 UIInstance::~UIInstance ()
@@ -38,15 +79,42 @@ UIInstance::~UIInstance ()
 
 void UIInstance::clear()
 {
+    // Deleting an adaptor unregisters it, so don't iterate the registry itself
+    Array<UIAdaptor*> remaining;
+    
     Registry::Iterator cursor (registry);
     while (cursor.next())
-        if (cursor.getValue() != nullptr && !cursor.getValue()->isWindowAdaptor())
+        if (cursor.getValue() != nullptr)
+            remaining.add (cursor.getValue());
+    
+    for (auto adaptor : remaining)
+    {
+        if (adaptor->isWindowAdaptor())
         {
-            DBG ("*** WARNING: Cleaning up leaked adaptor " << cursor.getValue()->identifier.quoted());
-            delete cursor.getValue();
+            hierarchy->remove (adaptor->key, adaptor);
         }
+        else
+        {
+            DBG ("*** WARNING: Cleaning up leaked adaptor " << adaptor->identifier.quoted());
+            delete adaptor;
+        }
+    }
     
     registry.clear();
+    
+    if (arena != nullptr)
+    {
+       #if ANS_DEBUG_UPDATES
+        DBG (printDebug() << " " << arena->getStatistics().toString());
+       #endif
+        // Blocks of components that are still alive keep their chunks until deleted
+        arena->reset();
+    }
+}
+
+UIArena::Statistics UIInstance::getArenaStatistics()
+{
+    return arena != nullptr ? arena->getStatistics() : UIArena::Statistics();
 }
 
 std::shared_ptr<UIInstance> UIInstance::getChildInstanceFor (UIModel* uiModel, UISpec* uiSpec)
@@ -69,7 +137,7 @@ bool UIInstance::registerAdaptor (UIAdaptor* adaptor)
     if (adaptor == nullptr)
         return false;
     
-    if (auto existing = registry[adaptor->identifier])
+    if (auto existing = registry[adaptor->key])
     {
         if (existing == adaptor)
             return true;
@@ -81,7 +149,8 @@ bool UIInstance::registerAdaptor (UIAdaptor* adaptor)
     }
     
     //DBG (model->getClass().getName() << " registering adaptor " << adaptor->identifier.quoted());
-    registry.set (adaptor->identifier, adaptor);
+    registry.set (adaptor->key, adaptor);
+    hierarchy->add (adaptor->key, adaptor);
     model->addDependent (adaptor);
     return true;
 }
@@ -96,24 +165,45 @@ void UIInstance::unregisterAdaptor (UIAdaptor* adaptor)
         //DBG (model->getClass().getName() << " unregistering adaptor " << adaptor->identifier.quoted());
         model->removeDependent (adaptor);
     }
-    registry.remove (adaptor->identifier);
+    // An adaptor that has been replaced must not remove its successor
+    if (registry[adaptor->key] == adaptor)
+        registry.remove (adaptor->key);
+    
+    hierarchy->remove (adaptor->key, adaptor);
 }
 
 UIAdaptor* UIInstance::getAdaptor (const ComponentID& identifier, bool lookIntoChildren)
 {
-    if (auto adaptor = registry[identifier])
+    // Nothing can be registered under a name that isn't a Symbol yet
+    const auto key = Symbol::find (identifier);
+    return key != 0 ? getAdaptorWithKey (key, lookIntoChildren) : nullptr;
+}
+
+UIAdaptor* UIInstance::getAdaptorWithKey (SymbolID key, bool lookIntoChildren)
+{
+    if (auto adaptor = registry[key])
         return adaptor;
     
     if (!lookIntoChildren)
         return nullptr;
     
-    for (auto child : children)
-        if (auto adaptor = child->getAdaptor (identifier, lookIntoChildren))
-            return adaptor;
+    if (auto candidates = hierarchy->find (key))
+        for (auto adaptor : *candidates)
+            if (adaptor->ui != nullptr && adaptor->ui->isWithin (this))
+                return adaptor;
     
     return nullptr;
 }
 
+bool UIInstance::isWithin (UIInstance* ancestor)
+{
+    if (this == ancestor)
+        return true;
+    
+    auto p = parent.lock();
+    return p != nullptr && p->isWithin (ancestor);
+}
+
 Component* UIInstance::getComponent (const ComponentID& identifier, bool lookIntoChildren)
 {
     if (auto adaptor = getAdaptor (identifier, lookIntoChildren))
@@ -154,7 +244,7 @@ void UIInstance::updateLayoutFromSpec()
     if (auto rootSpec = getSpec()->getRootComponentSpec())
     {
         updateLayoutFromSpec (rootSpec);
-        if (auto adaptor = getAdaptor (rootSpec->identifier))
+        if (auto adaptor = getAdaptorWithKey (rootSpec->key))
             if (auto comp = adaptor->getComponent())
                 comp->resized();
     }
@@ -165,12 +255,28 @@ void UIInstance::updateLayoutFromSpec (ComponentSpec* spec)
     if (spec == nullptr)
         return;
     
-    if (auto adaptor = getAdaptor (spec->identifier))
+    if (auto adaptor = getAdaptorWithKey (spec->key))
         spec->layout.applyToComponent (adaptor->getComponent());
     
     for (auto child : spec->children)
         updateLayoutFromSpec (child);
 }
 
+void UIInstance::synchronise()
+{
+    if (auto rootSpec = getSpec()->getRootComponentSpec())
+        synchronise (rootSpec);
+}
+
+void UIInstance::synchronise (ComponentSpec* spec)
+{
+    // Adaptors built into an existing composite (e.g. the root spec of an embedded UI) aren't ours
+    if (auto adaptor = getAdaptorWithKey (spec->key))
+        adaptor->synchronise();
+    
+    for (auto child : spec->children)
+        synchronise (child);
+}
+
 
 } //
@@ -24,6 +24,10 @@ class UIModel;
  
  There may be multiple UIInstances for the same UIModel. UIInstance serve for reference only
  and do not take ownwership of UIAdaptor/Component, which are owned by the component hierarchy.
+ 
+ Adaptors are registered by their identifier interned as Symbol. In addition, all instances of
+ a hierarchy share a flat index of all their adaptors, so lookups that include children don't
+ need to search the instance tree.
  */
 
 struct UIInstance :
@@ -63,6 +67,9 @@ struct UIInstance :
      If there is no such adaptor, the instance will also look into its children.
      */
     UIAdaptor* getAdaptor (const ComponentID& identifier, bool lookIntoChildren = false);
+    
+    /** Same as getAdaptor(), but using an identifier already interned as Symbol (@see ComponentSpec::key) */
+    UIAdaptor* getAdaptorWithKey (SymbolID key, bool lookIntoChildren = false);
 
     /**
      Get the component associated with an UIAdaptor that is registered with the identifier.
@@ -77,9 +84,25 @@ struct UIInstance :
     /** Whether this instance is used for mockup widgets only */
     bool isMockup() { return mockup; }
     
+    /**
+     The arena from which bindings and positioners of this instance are allocated while building,
+     or nullptr if ANS_USE_BUILD_ARENA is disabled (@see UIArena, UIBuilder)
+     */
+    UIArena* getArena() { return arena.get(); }
+    
+    /** Allocation counters of the arena, for judging how many malloc/free calls were saved */
+    UIArena::Statistics getArenaStatistics();
+    
     /** Re-deploy changes made to the UISpec regarding layout to all registered components (live editing) */
     void updateLayoutFromSpec();
     
+    /**
+     Bring all adaptors of this instance up to date after building, by performing each of their
+     getter bindings exactly once, in the order of the spec tree. Unlike broadcasting aspects
+     on the model, this does not touch adaptors of other instances open on the same model.
+     */
+    void synchronise();
+    
     String printDebug();
 
 protected:
@@ -87,16 +110,23 @@ protected:
     void childWasDeleted (UIInstance* child);
     
 private:
-    using Registry = HashMap<ComponentID,UIAdaptor*>;
+    using Registry = HashMap<SymbolID,UIAdaptor*>;
+    struct HierarchyIndex;
     
     std::shared_ptr<UIInstance> findChildFor (UIModel* m, UISpec* s);
+    bool isWithin (UIInstance* ancestor);
     void updateLayoutFromSpec (ComponentSpec* spec);
+    void synchronise (ComponentSpec* spec);
    
+    // Declared first, so it's released last
+    std::unique_ptr<UIArena, UIArena::Releaser> arena;
+    
     std::weak_ptr<UIInstance> parent;
     WeakReference<UISpec> spec;
     WeakReference<UIModel> model;
     Array<std::shared_ptr<UIInstance>> children; // owned
     Registry registry;
+    std::shared_ptr<HierarchyIndex> hierarchy; // shared by all instances of the same hierarchy
     std::shared_ptr<UIInstance> mockupUI;
     bool mockup;
     
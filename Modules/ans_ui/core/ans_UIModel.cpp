@@ -76,8 +76,8 @@ namespace ans
 
     void UIModel::postBuild (UIInstance& instance)
     {
-        changed (Visibility);
-        changedAspects (instance.getSpec()->getUsedAspects());
+        // Only the new instance needs updating, other windows on the same model are fine
+        instance.synchronise();
     }
 
     void UIModel::openUIEditor()
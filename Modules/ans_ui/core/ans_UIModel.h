@@ -152,7 +152,8 @@ public:
     /**
      Called by UIBuilder after building a UISpec. Subclasses can hook in here
      to do some setup work before the UI goes live. If so, they must also call
-     Parent::postBuild (instance) to ensure proper setup.
+     Parent::postBuild (instance) to ensure proper setup, which synchronises all
+     components of the new instance with the model.
      */
     virtual void postBuild (UIInstance& instance);
     
@@ -201,14 +201,6 @@ namespace ans {
         
         //  Opening/Closing
         
-        void postBuild (UIInstance& instance) override
-        {
-            if (instance.isForWindow())
-                changed ({TabContents, ModelSelection});
-            
-            Parent::postBuild (instance);
-        }
-        
         void postClose (UIInstance& instance) override
         {
             Parent::postClose (instance);
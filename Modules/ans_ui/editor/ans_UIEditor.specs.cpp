@@ -33,7 +33,7 @@ WeakReference<UISpec> UIEditor::MainWindowSpec = new UISpec
  []()
  {
     auto window = new WindowSpec ();
-    window->setLayout (LayoutFrame("50% - 600", "50% - 350", "1200 relative", "700 relative"));
+    window->setLayout (LayoutFrame(LayoutFrame::Side (0.5f, -600), LayoutFrame::Side (0.5f, -350), LayoutFrame::Side (0.0f, 1200, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 700, {0, INT_MAX}, true)));
     window->setLabel ("UIEditor");
     window->addBinding (Bind::GetLabel (MEMBER (&UIEditor::getWindowTitle), SpecSelection));
     {
@@ -70,13 +70,13 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
     main->setLabel ("Model");
     {
         auto l1 = new LabelSpec ("l1");
-        l1->setLayout (LayoutFrame("4", "4", "25% - 2 [150..2000]", "40 relative"));
+        l1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.25f, -2, {150, 2000}, false), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l1->setLabel ("Classes");
         main->addComponent (l1);
     }
     {
         auto modelTree = new TreeSpec ("modelTree");
-        modelTree->setLayout (LayoutFrame("4", "50", "25% - 2 [150..2000]", "100% - 150 [300..2000]"));
+        modelTree->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 50), LayoutFrame::Side (0.25f, -2, {150, 2000}, false), LayoutFrame::Side (1.0f, -150, {300, 2000}, false)));
         modelTree->addBinding (Bind::GetValue (MEMBER (&UIEditor::getModelTree), Values));
         modelTree->addBinding (Bind::GetSelection (MEMBER (&UIEditor::getModelTreeSelection), ModelSelection));
         modelTree->addBinding (Bind::SetSelection (MEMBER (&UIEditor::setModelTreeSelection)));
@@ -84,13 +84,13 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
     }
     {
         auto l2 = new LabelSpec ("l2");
-        l2->setLayout (LayoutFrame("25% + 2 [154..2000]", "4", "50% - 2 [300..2000]", "40 relative"));
+        l2->setLayout (LayoutFrame(LayoutFrame::Side (0.25f, 2, {154, 2000}, false), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.5f, -2, {300, 2000}, false), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l2->setLabel ("Specs");
         main->addComponent (l2);
     }
     {
         auto specsList = new ListSpec ("specsList");
-        specsList->setLayout (LayoutFrame("25% + 2 [154..2000]", "50", "50% - 2 [300..2000]", "100% - 150 [300..2000]"));
+        specsList->setLayout (LayoutFrame(LayoutFrame::Side (0.25f, 2, {154, 2000}, false), LayoutFrame::Side (0.0f, 50), LayoutFrame::Side (0.5f, -2, {300, 2000}, false), LayoutFrame::Side (1.0f, -150, {300, 2000}, false)));
         specsList->addBinding (Bind::GetValue (MEMBER (&UIEditor::getSpecsList), ModelSelection));
         specsList->addBinding (Bind::GetSelection (MEMBER (&UIEditor::getSpecsListSelection), SpecSelection));
         specsList->addBinding (Bind::SetSelection (MEMBER (&UIEditor::setSpecsListSelection)));
@@ -98,16 +98,16 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
     }
     {
         auto l3 = new LabelSpec ("l3");
-        l3->setLayout (LayoutFrame("50% + 2 [304..2000]", "4", "50% + 200 [500..2000]", "40 relative"));
+        l3->setLayout (LayoutFrame(LayoutFrame::Side (0.5f, 2, {304, 2000}, false), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.5f, 200, {500, 2000}, false), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l3->setLabel ("Aspects");
         main->addComponent (l3);
     }
     {
         auto aspectsEditor = new CompositeSpec ("aspectsEditor");
-        aspectsEditor->setLayout (LayoutFrame("50% + 2 [304..2000]", "50", "50% + 200 [500..2000]", "100% - 150 [300..2000]"));
+        aspectsEditor->setLayout (LayoutFrame(LayoutFrame::Side (0.5f, 2, {304, 2000}, false), LayoutFrame::Side (0.0f, 50), LayoutFrame::Side (0.5f, 200, {500, 2000}, false), LayoutFrame::Side (1.0f, -150, {300, 2000}, false)));
         {
             auto aspectsList = new ListSpec ("aspectsList", ModelSettings);
-            aspectsList->setLayout (LayoutFrame("0", "0", "100%", "100% - 60"));
+            aspectsList->setLayout (LayoutFrame(0.0f, 0, 0.0f, 0, 1.0f, 0, 1.0f, -60));
             aspectsList->addBinding (Bind::GetValue (MEMBER (&UIEditor::getAspectsList), ModelAspects));
             aspectsList->addBinding (Bind::GetSelection (MEMBER (&UIEditor::getAspectsListSelection), ModelSettings));
             aspectsList->addBinding (Bind::SetSelection (MEMBER (&UIEditor::setAspectsListSelection)));
@@ -115,7 +115,7 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
         }
         {
             auto aspectNew = new ButtonSpec ("aspectNew");
-            aspectNew->setLayout (LayoutFrame("0", "100% - 50", "50% - 2", "100% - 28"));
+            aspectNew->setLayout (LayoutFrame(0.0f, 0, 1.0f, -50, 0.5f, -2, 1.0f, -28));
             aspectNew->setLabel ("+");
             aspectNew->addBinding (Bind::Action (MEMBER (&UIEditor::newAspectName)));
             aspectNew->addBinding (Bind::GetEnabled (MEMBER (&UIEditor::getEditingEnabled), Visibility));
@@ -123,7 +123,7 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
         }
         {
             auto aspectRemove = new ButtonSpec ("aspectRemove");
-            aspectRemove->setLayout (LayoutFrame("50% + 2", "100% - 50", "100%", "100% - 28"));
+            aspectRemove->setLayout (LayoutFrame(0.5f, 2, 1.0f, -50, 1.0f, 0, 1.0f, -28));
             aspectRemove->setLabel ("-");
             aspectRemove->addBinding (Bind::Action (MEMBER (&UIEditor::removeAspectName)));
             aspectRemove->addBinding (Bind::GetEnabled (MEMBER (&UIEditor::getEditingEnabled), Visibility));
@@ -131,7 +131,7 @@ WeakReference<UISpec> UIEditor::TabSpecModel = new UISpec
         }
         {
             auto aspectInput = new InputSpec ("aspectInput", ModelSettings);
-            aspectInput->setLayout (LayoutFrame("0", "100% - 26", "100%", "100%"));
+            aspectInput->setLayout (LayoutFrame(0.0f, 0, 1.0f, -26, 1.0f, 0, 1.0f, 0));
             aspectInput->addBinding (Bind::GetValue (MEMBER (&UIEditor::getAspectName), ModelSettings));
             aspectInput->addBinding (Bind::SetValue (MEMBER (&UIEditor::setAspectName)));
             aspectInput->addBinding (Bind::GetEnabled (MEMBER (&UIEditor::getEditingEnabled), ModelSettings));
@@ -156,7 +156,7 @@ WeakReference<UISpec> UIEditor::TabSpecLayout = new UISpec
     tabLayout->setLabel ("Layout");
     {
         auto leftPart = new CompositeSpec ("leftPart");
-        leftPart->setLayout (LayoutFrame("4", "4", "25% - 2 [150..300]", "100% - 4"));
+        leftPart->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.25f, -2, {150, 300}, false), LayoutFrame::Side (1.0f, -4)));
         {
             auto componentTree = new TreeSpec ("componentTree");
             componentTree->setMultipleSelectionEnabled (true);
@@ -169,7 +169,7 @@ WeakReference<UISpec> UIEditor::TabSpecLayout = new UISpec
     }
     {
         auto middlePart = new CompositeSpec ("middlePart");
-        middlePart->setLayout (LayoutFrame("25% + 2 [150..300]", "4", "100% - 250", "100% - 4"));
+        middlePart->setLayout (LayoutFrame(LayoutFrame::Side (0.25f, 2, {150, 300}, false), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -250), LayoutFrame::Side (1.0f, -4)));
         middlePart->setBackgroundColour (SOURCE (Colours::darkkhaki));
         {
             auto layoutCanvas = new CanvasSpec ("layoutCanvas");
@@ -180,7 +180,7 @@ WeakReference<UISpec> UIEditor::TabSpecLayout = new UISpec
     }
     {
         auto rightPart = new CompositeSpec ("rightPart");
-        rightPart->setLayout (LayoutFrame("100% - 246", "4", "100% - 4", "100% - 4"));
+        rightPart->setLayout (LayoutFrame(1.0f, -246, 0.0f, 4, 1.0f, -4, 1.0f, -4));
         {
             auto inspectorCanvas = new CanvasSpec ("inspectorCanvas");
             inspectorCanvas->addBinding (Bind::Canvas (MEMBER (&UIEditor::populateInspectorCanvas), ComponentSelection));
@@ -205,7 +205,7 @@ WeakReference<UISpec> UIEditor::TabSpecGraphics = new UISpec
     tabGraphics->setLabel ("Graphics");
     {
         auto l1 = new LabelSpec ("l1");
-        l1->setLayout (LayoutFrame("4", "4", "100% - 4", "40 relative"));
+        l1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -4), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l1->setLabel ("...");
         tabGraphics->addComponent (l1);
     }
@@ -226,7 +226,7 @@ WeakReference<UISpec> UIEditor::TabSpecResources = new UISpec
     tabResources->setLabel ("Resources");
     {
         auto l1 = new LabelSpec ("l1");
-        l1->setLayout (LayoutFrame("4", "4", "100% - 4", "40 relative"));
+        l1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -4), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l1->setLabel ("...");
         tabResources->addComponent (l1);
     }
@@ -247,13 +247,13 @@ WeakReference<UISpec> UIEditor::TabSpecCode = new UISpec
     tabCode->setLabel ("Code");
     {
         auto label1 = new LabelSpec ("label1");
-        label1->setLayout (LayoutFrame("4", "4", "100% - 210", "22 relative"));
+        label1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -210), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
         label1->addBinding (Bind::GetLabel (MEMBER (&UIEditor::getCodeLabel), Labels));
         tabCode->addComponent (label1);
     }
     {
         auto saveButton = new ButtonSpec ("saveButton");
-        saveButton->setLayout (LayoutFrame("100% - 204", "4", "200 relative", "22 relative"));
+        saveButton->setLayout (LayoutFrame(LayoutFrame::Side (1.0f, -204), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 200, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
         saveButton->setLabel ("Save Now");
         saveButton->addBinding (Bind::GetEnabled (MEMBER (&UIEditor::getEditingEnabled), Visibility));
         saveButton->addBinding (Bind::Action (MEMBER (&UIEditor::saveButtonClicked)));
@@ -261,13 +261,13 @@ WeakReference<UISpec> UIEditor::TabSpecCode = new UISpec
     }
     {
         auto codeHPP = new CodeSpec ("codeHPP");
-        codeHPP->setLayout (LayoutFrame("4", "28", "100% - 4", "50% - 2"));
+        codeHPP->setLayout (LayoutFrame(0.0f, 4, 0.0f, 28, 1.0f, -4, 0.5f, -2));
         codeHPP->addBinding (Bind::GetValue (MEMBER (&UIEditor::getCodeHPP), ModelSettings));
         tabCode->addComponent (codeHPP);
     }
     {
         auto codeCPP = new CodeSpec ("codeCPP");
-        codeCPP->setLayout (LayoutFrame("4", "50% + 2", "100% - 4", "100% - 4"));
+        codeCPP->setLayout (LayoutFrame(0.0f, 4, 0.5f, 2, 1.0f, -4, 1.0f, -4));
         codeCPP->addBinding (Bind::GetValue (MEMBER (&UIEditor::getCodeCPP), ModelSettings));
         tabCode->addComponent (codeCPP);
     }
@@ -31,6 +31,9 @@ const ComponentID ComponentSpecInspector::getSuggestedID (const ComponentID& bas
 
 void ComponentSpecInspector::updateLayout()
 {
+    // Sub-inspectors may have changed the spec directly
+    if (auto uiSpec = getSelectedUISpec())
+        uiSpec->specEdited();
     changed (ComponentLayout);
     getUIEditor()->updateLayoutCanvas();
 }
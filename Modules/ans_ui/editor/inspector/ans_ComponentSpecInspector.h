@@ -55,10 +55,10 @@ public:
     
     
     String  getIdentifier () { return selectedComponentSpec->identifier; }
-    void    setIdentifier (const String& input) { selectedComponentSpec->identifier = input; updateLayout(); }
+    void    setIdentifier (const String& input) { selectedComponentSpec->setIdentifier (input); updateLayout(); }
     
     String  getLabel () { return selectedComponentSpec->label; }
-    void    setLabel (const String& input) { selectedComponentSpec->label = input; updateLayout();  }
+    void    setLabel (const String& input) { selectedComponentSpec->setLabel (input); updateLayout();  }
     
     String  getTooltip () { return selectedComponentSpec->tooltip; }
     void    setTooltip (const String& input) { selectedComponentSpec->tooltip = input; updateLayout();  }
@@ -40,6 +40,30 @@ void LayoutSpecInspector::populateInspector (CompositeSpec* composite, LayoutCur
                               "title",
                               "Layout");
     
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputType",
+                              "Type",
+                              MEMBER (&LayoutSpecInspector::getType),
+                              MEMBER (&LayoutSpecInspector::setType),
+                              LayoutSettings);
+    
+    switch (getLayoutSpec().type)
+    {
+        case LayoutSpec::Frame:
+            populateFrame (composite, cursor);
+            break;
+        case LayoutSpec::Grid:
+            populateGrid (composite, cursor);
+            break;
+        case LayoutSpec::Flex:
+            populateFlex (composite, cursor);
+            break;
+    }
+}
+
+void LayoutSpecInspector::populateFrame (CompositeSpec* composite, LayoutCursor& cursor)
+{
     mainInspector->makeInput (composite,
                               cursor,
                               "inputLeft",
@@ -70,7 +94,232 @@ void LayoutSpecInspector::populateInspector (CompositeSpec* composite, LayoutCur
                               "Bottom",
                               MEMBER (&LayoutSpecInspector::getBottom),
                               MEMBER (&LayoutSpecInspector::setBottom),
-                              LayoutSettings);    
+                              LayoutSettings);
+}
+
+void LayoutSpecInspector::populateGrid (CompositeSpec* composite, LayoutCursor& cursor)
+{
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputColumns",
+                              "Columns",
+                              MEMBER (&LayoutSpecInspector::getColumns),
+                              MEMBER (&LayoutSpecInspector::setColumns),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputRows",
+                              "Rows",
+                              MEMBER (&LayoutSpecInspector::getRows),
+                              MEMBER (&LayoutSpecInspector::setRows),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputGap",
+                              "Gap",
+                              MEMBER (&LayoutSpecInspector::getGap),
+                              MEMBER (&LayoutSpecInspector::setGap),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputCell",
+                              "Cell",
+                              MEMBER (&LayoutSpecInspector::getCell),
+                              MEMBER (&LayoutSpecInspector::setCell),
+                              LayoutSettings);
+}
+
+void LayoutSpecInspector::populateFlex (CompositeSpec* composite, LayoutCursor& cursor)
+{
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputDirection",
+                              "Direction",
+                              MEMBER (&LayoutSpecInspector::getDirection),
+                              MEMBER (&LayoutSpecInspector::setDirection),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputWrap",
+                              "Wrap",
+                              MEMBER (&LayoutSpecInspector::getWrap),
+                              MEMBER (&LayoutSpecInspector::setWrap),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputJustify",
+                              "Justify",
+                              MEMBER (&LayoutSpecInspector::getJustify),
+                              MEMBER (&LayoutSpecInspector::setJustify),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputAlign",
+                              "Align",
+                              MEMBER (&LayoutSpecInspector::getAlign),
+                              MEMBER (&LayoutSpecInspector::setAlign),
+                              LayoutSettings);
+    
+    mainInspector->makeInput (composite,
+                              cursor,
+                              "inputFlex",
+                              "Flex",
+                              MEMBER (&LayoutSpecInspector::getFlex),
+                              MEMBER (&LayoutSpecInspector::setFlex),
+                              LayoutSettings);
+}
+
+String LayoutSpecInspector::getType()
+{
+    return LayoutSpec::TypeNames[getLayoutSpec().type];
+}
+
+void LayoutSpecInspector::setType (const String& input)
+{
+    const int index = LayoutSpec::TypeNames.indexOf (input.trim(), true);
+    if (index < 0 || index == (int)getLayoutSpec().type)
+        return;
+    
+    getLayoutSpec().type = (LayoutSpec::Type)index;
+    
+    // Other fields apply now
+    changed (SpecSelection);
+    update();
+}
+
+String LayoutSpecInspector::getDirection()
+{
+    return LayoutSpec::FlexDirectionNames[(int)getLayoutSpec().flexBox.flexDirection];
+}
+
+void LayoutSpecInspector::setDirection (const String& input)
+{
+    const int index = LayoutSpec::FlexDirectionNames.indexOf (input.trim(), true);
+    if (index >= 0)
+        getLayoutSpec().flexBox.flexDirection = (FlexBox::Direction)index;
+    update();
+}
+
+String LayoutSpecInspector::getWrap()
+{
+    return LayoutSpec::FlexWrapNames[(int)getLayoutSpec().flexBox.flexWrap];
+}
+
+void LayoutSpecInspector::setWrap (const String& input)
+{
+    const int index = LayoutSpec::FlexWrapNames.indexOf (input.trim(), true);
+    if (index >= 0)
+        getLayoutSpec().flexBox.flexWrap = (FlexBox::Wrap)index;
+    update();
+}
+
+String LayoutSpecInspector::getJustify()
+{
+    return LayoutSpec::FlexJustifyNames[(int)getLayoutSpec().flexBox.justifyContent];
+}
+
+void LayoutSpecInspector::setJustify (const String& input)
+{
+    const int index = LayoutSpec::FlexJustifyNames.indexOf (input.trim(), true);
+    if (index >= 0)
+        getLayoutSpec().flexBox.justifyContent = (FlexBox::JustifyContent)index;
+    update();
+}
+
+String LayoutSpecInspector::getAlign()
+{
+    return LayoutSpec::FlexAlignItemsNames[(int)getLayoutSpec().flexBox.alignItems];
+}
+
+void LayoutSpecInspector::setAlign (const String& input)
+{
+    const int index = LayoutSpec::FlexAlignItemsNames.indexOf (input.trim(), true);
+    if (index >= 0)
+        getLayoutSpec().flexBox.alignItems = (FlexBox::AlignItems)index;
+    update();
+}
+
+String LayoutSpecInspector::getFlex()
+{
+    auto& item = getLayoutSpec().flexItem;
+    return String (item.flexGrow) + " " + String (item.flexShrink) + " " + String (item.flexBasis);
+}
+
+void LayoutSpecInspector::setFlex (const String& input)
+{
+    auto tokens = StringArray::fromTokens (input, false);
+    auto& item = getLayoutSpec().flexItem;
+    
+    if (tokens.size() > 0) item.flexGrow   = tokens[0].getFloatValue();
+    if (tokens.size() > 1) item.flexShrink = tokens[1].getFloatValue();
+    if (tokens.size() > 2) item.flexBasis  = tokens[2].getFloatValue();
+    update();
+}
+
+void LayoutSpecInspector::setColumns (const String& input)
+{
+    auto& spec = getLayoutSpec();
+    spec.setGridTracks (input, spec.gridRows, spec.gridGap);
+    update();
+}
+
+void LayoutSpecInspector::setRows (const String& input)
+{
+    auto& spec = getLayoutSpec();
+    spec.setGridTracks (spec.gridColumns, input, spec.gridGap);
+    update();
+}
+
+void LayoutSpecInspector::setGap (const String& input)
+{
+    auto& spec = getLayoutSpec();
+    spec.setGridTracks (spec.gridColumns, spec.gridRows, jmax (0, input.getIntValue()));
+    update();
+}
+
+String LayoutSpecInspector::getCell()
+{
+    auto& item = getLayoutSpec().gridItem;
+    
+    if (! item.row.start.hasAbsolute() || ! item.column.start.hasAbsolute())
+        return "auto";
+    
+    String out;
+    out << item.row.start.getNumber() << " " << item.column.start.getNumber();
+    
+    if (item.row.end.hasAbsolute() && item.column.end.hasAbsolute())
+        out << " " << item.row.end.getNumber() << " " << item.column.end.getNumber();
+    
+    return out;
+}
+
+void LayoutSpecInspector::setCell (const String& input)
+{
+    auto tokens = StringArray::fromTokens (input, false);
+    auto& item = getLayoutSpec().gridItem;
+    
+    if (tokens.size() >= 2)
+    {
+        const int row = jmax (1, tokens[0].getIntValue());
+        const int column = jmax (1, tokens[1].getIntValue());
+        const int rowEnd = tokens.size() >= 4 ? jmax (row + 1, tokens[2].getIntValue()) : row + 1;
+        const int columnEnd = tokens.size() >= 4 ? jmax (column + 1, tokens[3].getIntValue()) : column + 1;
+        
+        item.row = { row, rowEnd };
+        item.column = { column, columnEnd };
+    }
+    else
+    {
+        item.row = {};
+        item.column = {};
+    }
+    update();
 }
 
 void LayoutSpecInspector::update()
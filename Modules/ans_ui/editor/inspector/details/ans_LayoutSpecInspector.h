@@ -15,7 +15,7 @@ namespace ans {
 class ComponentSpecInspector;
 
 
-/** LayoutSpecInspector edits a LayoutSpec. It offers the flexibility to support more types of layout, e.g. FlexBox */
+/** LayoutSpecInspector edits a LayoutSpec: a LayoutFrame, or the main properties of a Grid or FlexBox and the item placing the component in its parent's */
 
 class LayoutSpecInspector : public EmbeddedUIModel
 {
@@ -40,6 +40,42 @@ public:
     String  getBottom ()                    { return getLayoutSpec().frame.bottom.print(); }
     void    setBottom (const String& input) { getLayoutSpec().frame.bottom.parse(input); update(); }
     
+    String  getType ();
+    void    setType (const String& input);
+    
+    // FlexBox
+    
+    String  getDirection ();
+    void    setDirection (const String& input);
+    
+    String  getWrap ();
+    void    setWrap (const String& input);
+    
+    String  getJustify ();
+    void    setJustify (const String& input);
+    
+    String  getAlign ();
+    void    setAlign (const String& input);
+    
+    /** FlexItem as "grow shrink basis" */
+    String  getFlex ();
+    void    setFlex (const String& input);
+    
+    // Grid
+    
+    String  getColumns ()                   { return getLayoutSpec().gridColumns; }
+    void    setColumns (const String& input);
+    
+    String  getRows ()                      { return getLayoutSpec().gridRows; }
+    void    setRows (const String& input);
+    
+    String  getGap ()                       { return String (getLayoutSpec().gridGap); }
+    void    setGap (const String& input);
+    
+    /** GridItem as "row column [rowEnd columnEnd]", lines numbered from 1 */
+    String  getCell ();
+    void    setCell (const String& input);
+    
     void update();
     
     void buildCanvas (UIComposite* canvas)
@@ -54,6 +90,9 @@ public:
     }
     
     void populateInspector (CompositeSpec* composite, LayoutCursor& cursor);
+    void populateFrame (CompositeSpec* composite, LayoutCursor& cursor);
+    void populateGrid  (CompositeSpec* composite, LayoutCursor& cursor);
+    void populateFlex  (CompositeSpec* composite, LayoutCursor& cursor);
     
     bool hasUIEditorLink() override { return false; }
     
@@ -8,6 +8,7 @@
  */
 
 #include "ans_ComponentSpec.h"
+#include "ans_UISpec.h"
 #include "../utility/ans_Positioners.h"
 #include "../core/ans_UIBuilder.h"
 #include "../core/ans_UIInstance.h"
@@ -95,9 +96,49 @@ namespace ans {
     
     const StringArray LayoutSpec::TypeNames = {
         "Frame",
+        "Grid",
         "Flex"
     };
     
+    // These follow the order of the enums in juce::FlexBox
+    
+    const StringArray LayoutSpec::FlexDirectionNames = {
+        "row",
+        "rowReverse",
+        "column",
+        "columnReverse"
+    };
+    
+    const StringArray LayoutSpec::FlexWrapNames = {
+        "noWrap",
+        "wrap",
+        "wrapReverse"
+    };
+    
+    const StringArray LayoutSpec::FlexAlignContentNames = {
+        "stretch",
+        "flexStart",
+        "flexEnd",
+        "center",
+        "spaceBetween",
+        "spaceAround"
+    };
+    
+    const StringArray LayoutSpec::FlexAlignItemsNames = {
+        "stretch",
+        "flexStart",
+        "flexEnd",
+        "center"
+    };
+    
+    const StringArray LayoutSpec::FlexJustifyNames = {
+        "flexStart",
+        "flexEnd",
+        "center",
+        "spaceBetween",
+        "spaceAround"
+    };
+    
     LayoutSpec::LayoutSpec () :
     type (Frame),
     frame ()
@@ -117,6 +158,122 @@ namespace ans {
         return spec;
     }
     
+    LayoutSpec LayoutSpec::forFlexBox (const FlexBox& box, const FlexItem& item)
+    {
+        LayoutSpec spec;
+        spec.type = Flex;
+        spec.flexBox = box;
+        spec.flexItem = item;
+        return spec;
+    }
+    
+    LayoutSpec LayoutSpec::forGrid (const String& columns, const String& rows, int gap, const GridItem& item)
+    {
+        LayoutSpec spec;
+        spec.type = Grid;
+        spec.setGridTracks (columns, rows, gap);
+        spec.gridItem = item;
+        return spec;
+    }
+    
+    void LayoutSpec::setGridTracks (const String& columns, const String& rows, int gap)
+    {
+        gridColumns = columns.trim();
+        gridRows = rows.trim();
+        gridGap = gap;
+        grid.templateColumns = parseTracks (gridColumns);
+        grid.templateRows = parseTracks (gridRows);
+        grid.columnGap = juce::Grid::Px (gap);
+        grid.rowGap = juce::Grid::Px (gap);
+    }
+    
+    Array<juce::Grid::TrackInfo> LayoutSpec::parseTracks (const String& source)
+    {
+        Array<juce::Grid::TrackInfo> tracks;
+        
+        for (auto token : StringArray::fromTokens (source, false))
+        {
+            if (token.endsWithIgnoreCase ("fr"))
+                tracks.add (juce::Grid::Fr (jmax (1, token.getIntValue())));
+            else if (token.containsOnly ("0123456789.px"))
+                tracks.add (juce::Grid::Px (token.getIntValue()));
+            else
+                DBG ("*** ERROR: Unknown grid track " << token.quoted());
+        }
+        return tracks;
+    }
+    
+    String LayoutSpec::generateSourceCPP () const
+    {
+        String out;
+        
+        switch (type)
+        {
+            case Frame:
+                return frame.generateSourceCPP();
+                
+            case Flex:
+            {
+                out << "LayoutSpec::forFlexBox (FlexBox ("
+                    << "FlexBox::Direction::"      << EnumHelpers::print (FlexDirectionNames,    (int)flexBox.flexDirection)  << ", "
+                    << "FlexBox::Wrap::"           << EnumHelpers::print (FlexWrapNames,         (int)flexBox.flexWrap)       << ", "
+                    << "FlexBox::AlignContent::"   << EnumHelpers::print (FlexAlignContentNames, (int)flexBox.alignContent)   << ", "
+                    << "FlexBox::AlignItems::"     << EnumHelpers::print (FlexAlignItemsNames,   (int)flexBox.alignItems)     << ", "
+                    << "FlexBox::JustifyContent::" << EnumHelpers::print (FlexJustifyNames,      (int)flexBox.justifyContent) << "), "
+                    << "FlexItem()";
+                
+                // Only what differs from the defaults
+                const FlexItem standard;
+                const auto& item = flexItem;
+                
+                auto f = [] (float value) { return SourceOutputStream::floatLiteral (value); };
+                
+                if (item.flexGrow != standard.flexGrow || item.flexShrink != standard.flexShrink || item.flexBasis != standard.flexBasis)
+                    out << ".withFlex (" << f (item.flexGrow) << ", " << f (item.flexShrink) << ", " << f (item.flexBasis) << ")";
+                if (item.width != standard.width)           out << ".withWidth (" << f (item.width) << ")";
+                if (item.height != standard.height)         out << ".withHeight (" << f (item.height) << ")";
+                if (item.minWidth != standard.minWidth)     out << ".withMinWidth (" << f (item.minWidth) << ")";
+                if (item.minHeight != standard.minHeight)   out << ".withMinHeight (" << f (item.minHeight) << ")";
+                if (item.maxWidth != standard.maxWidth)     out << ".withMaxWidth (" << f (item.maxWidth) << ")";
+                if (item.maxHeight != standard.maxHeight)   out << ".withMaxHeight (" << f (item.maxHeight) << ")";
+                if (item.order != standard.order)           out << ".withOrder (" << item.order << ")";
+                
+                const auto& m = item.margin;
+                if (m.top != 0 || m.right != 0 || m.bottom != 0 || m.left != 0)
+                    out << ".withMargin (FlexItem::Margin (" << f (m.top) << ", " << f (m.right) << ", " << f (m.bottom) << ", " << f (m.left) << "))";
+                
+                out << ")";
+                return out;
+            }
+                
+            case Grid:
+            {
+                out << "LayoutSpec::forGrid (" << gridColumns.quoted() << ", " << gridRows.quoted() << ", " << gridGap << ", GridItem()";
+                
+                auto property = [] (const GridItem::Property& p) -> String
+                {
+                    if (p.hasSpan())     return "GridItem::Span (" + String (p.getNumber()) + ")";
+                    if (p.hasName())     return p.getName().quoted();
+                    if (p.hasAbsolute()) return String (p.getNumber());
+                    return "GridItem::Keyword::autoValue";
+                };
+                
+                const auto& item = gridItem;
+                if (! item.row.start.hasAuto() || ! item.row.end.hasAuto())
+                    out << ".withRow ({ " << property (item.row.start) << ", " << property (item.row.end) << " })";
+                if (! item.column.start.hasAuto() || ! item.column.end.hasAuto())
+                    out << ".withColumn ({ " << property (item.column.start) << ", " << property (item.column.end) << " })";
+                
+                out << ")";
+                return out;
+            }
+                
+            default:
+                DBG ("*** ERROR: Unsupported layout type specified: " << (int)type);
+                return frame.generateSourceCPP();
+        }
+    }
+    
     void LayoutSpec::applyToComponent (Component* comp) const
     {
         if (comp == nullptr)
@@ -126,6 +283,11 @@ namespace ans {
         {
             case LayoutSpec::Type::Frame:
             {
+                // An unchanged frame keeps its positioner, along with what it memoised
+                if (auto existing = dynamic_cast<FramePositioner*> (comp->getPositioner()))
+                    if (existing->frame == frame)
+                        break;
+                
                 comp->setPositioner (new FramePositioner (*comp, frame));
                 break;
             }
@@ -151,6 +313,20 @@ namespace ans {
 #pragma mark ComponentSpec
 #endif
     
+    void ComponentSpec::specEdited ()
+    {
+        if (owner != nullptr)
+            owner->specEdited();
+    }
+    
+    void ComponentSpec::setOwner (UISpec* uiSpec)
+    {
+        owner = uiSpec;
+        
+        for (auto child : children)
+            child->setOwner (uiSpec);
+    }
+    
     ComponentSpec* ComponentSpec::Class::newFor (ComponentSpecInspector* inspector)
     {
         return new ComponentSpec (UIComponentClass::Type::Composite, inspector->getSuggestedID ("composite"));
@@ -189,6 +365,7 @@ namespace ans {
             }
         }
         bindings.add (binding);
+        specEdited();
     }
     
     String ComponentSpec::generateSourceCPP (Model::Class* modelClass) const
@@ -208,8 +385,8 @@ namespace ans {
     {
         generateSourceCreation (modelClass, out);
         
-        if (layout.type == LayoutSpec::Frame && LayoutFrame::entire() != layout.frame)
-            out << identifier << "->setLayout (" << layout.frame.generateSourceCPP() << ");" << newLine;
+        if (layout.type != LayoutSpec::Frame || LayoutFrame::entire() != layout.frame)
+            out << identifier << "->setLayout (" << layout.generateSourceCPP() << ");" << newLine;
         
         if (label.isNotEmpty())
             out << identifier << "->setLabel (" << label.quoted() << ");" << newLine;
@@ -217,6 +394,9 @@ namespace ans {
         for (auto c : colours.assignments)
             out << identifier << "->setColour (0x" << String::toHexString(c.identifier).toUpperCase() << ", " << c.generateSourceCPP() << ");" << newLine;
         
+        if (renderCache != RenderCache::Policy::Never)
+            out << identifier << "->setRenderCache (RenderCache::Policy::" << EnumHelpers::print (RenderCache::PolicyNames, (int)renderCache) << ");" << newLine;
+        
         generateSourceProperties (modelClass, out);
         
         for (auto b : bindings)
@@ -253,7 +433,12 @@ namespace ans {
     Aspects ComponentSpec::getUsedAspects () const
     {
         Aspects answer;
-        
+        collectUsedAspects (answer);
+        return answer;
+    }
+    
+    void ComponentSpec::collectUsedAspects (Aspects& answer) const
+    {
         if (aspect != Model::Undefined)
             answer.add (aspect);
         
@@ -262,10 +447,7 @@ namespace ans {
                 answer.add (bind->getAspect());
         
         for (auto& child : children)
-            for (auto a : child->getUsedAspects())
-                answer.add (a);
-        
-        return answer;
+            child->collectUsedAspects (answer);
     }
     
     
@@ -347,6 +529,24 @@ namespace ans {
     
     //==========================================================================================================
 #if 0
+#pragma mark VirtualFormSpec
+#endif
+    
+    void VirtualFormSpec::generateSourceProperties (Model::Class* modelClass, SourceOutputStream& out) const
+    {
+        CompositeSpecBase::generateSourceProperties (modelClass, out);
+        
+        const VirtualFormSpec defaults ("");
+        
+        if (overscan != defaults.overscan)
+            out << identifier << "->setOverscan (" << overscan << ");" << newLine;
+        
+        if (cacheSize != defaults.cacheSize)
+            out << identifier << "->setCacheSize (" << cacheSize << ");" << newLine;
+    }
+    
+    //==========================================================================================================
+#if 0
 #pragma mark ListSpecBase
 #endif
     
@@ -419,6 +619,7 @@ namespace ans {
     std::unique_ptr<Component> ImageSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { return std::make_unique<UIImage> (instance, *this); }
     std::unique_ptr<Component> ImagePreviewSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { return std::make_unique<UIImagePreview> (instance, *this); }
     std::unique_ptr<Component> CanvasSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { return std::make_unique<UIComposite> (instance, *this); }
+    std::unique_ptr<Component> VirtualFormSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { return std::make_unique<UIVirtualForm> (instance, *this); }
     std::unique_ptr<Component> UserDefinedSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { return std::make_unique<UIUserDefinedComponent> (instance, *this); }
     
     std::unique_ptr<Component> WindowSpec::buildInstance (std::shared_ptr<UIInstance> instance) const { jassertfalse; return nullptr; }
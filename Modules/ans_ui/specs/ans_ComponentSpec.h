@@ -19,6 +19,7 @@
 #include "../core/ans_Binding.h"
 #include "../core/ans_Selection.h"
 #include "../utility/ans_LayoutFrame.h"
+#include "../utility/ans_RenderCache.h"
 #include "../utility/ans_SourceOutputStream.h"
 #include "../specs/ans_UIComponentClass.h"
 
@@ -43,7 +44,12 @@ typedef Array<std::pair<int,String>> UIValueMap;
 
 /**
  LayoutSpec holds all parameters required to create a layout object that
- computes the relative position of a component. Currently FlexBox and LayoutFrame are supported.
+ computes the relative position of a component. LayoutFrame, Grid and FlexBox are supported.
+ 
+ A Grid or FlexBox applies to the children of the component, while the GridItem or FlexItem
+ places the component in its parent's Grid or FlexBox. Since Grid::TrackInfo can't be inspected,
+ grid tracks are also kept as text (e.g. "1fr 2fr 120px"), which is what the editor edits and
+ code is generated from.
  */
 struct LayoutSpec
 {
@@ -56,10 +62,21 @@ struct LayoutSpec
     
     /** Labels used for generating code and parsing input */
     static const StringArray TypeNames;
+    static const StringArray FlexDirectionNames;
+    static const StringArray FlexWrapNames;
+    static const StringArray FlexAlignContentNames;
+    static const StringArray FlexAlignItemsNames;
+    static const StringArray FlexJustifyNames;
     
     /** Convenience: Proportional layout that fills entire parent area */
     static LayoutSpec entire ();
     
+    /** Convenience: FlexBox layout of the children, and placement in a parent FlexBox */
+    static LayoutSpec forFlexBox (const FlexBox& box, const FlexItem& item = FlexItem());
+    
+    /** Convenience: Grid layout of the children with tracks given as text, and placement in a parent Grid */
+    static LayoutSpec forGrid (const String& columns, const String& rows, int gap = 0, const GridItem& item = GridItem());
+    
     LayoutSpec ();
     LayoutSpec (const LayoutFrame& f) : type(Frame), frame(f) {}
    ~LayoutSpec () {}
@@ -67,12 +84,24 @@ struct LayoutSpec
     /**  Attach an appropriate Positioner to the Component, according to the spec's properties */
     void applyToComponent (Component* comp) const;
     
+    /** Set the grid tracks from text like "1fr 2fr 120px" (px may be omitted) and the gap between cells */
+    void setGridTracks (const String& columns, const String& rows, int gap);
+    
+    /** Parse a track list as used by setGridTracks() */
+    static Array<juce::Grid::TrackInfo> parseTracks (const String& source);
+    
+    /** For use in C++ expressions, i.e. as argument to ComponentSpec::setLayout() */
+    String generateSourceCPP () const;
+    
     Type type = Type::Frame;
     LayoutFrame frame;
     juce::Grid grid;
     juce::GridItem gridItem;
     juce::FlexBox flexBox;      // Placement rules for children, if any
     juce::FlexItem flexItem;    // Placement in parent FlexBox, if any
+    String gridColumns;         // Tracks of grid as text
+    String gridRows;
+    int gridGap = 0;
 };
 
 //=====================================================================================================
@@ -138,6 +167,7 @@ public:
     ComponentSpec (UIComponentClass::Type t, const ComponentID& n, Aspect a = Model::Undefined) :
         type (t),
         identifier (n),
+        key (Symbol::intern (n)),
         layout (LayoutFrame::entire()),
         aspect (a)
     {}
@@ -160,11 +190,20 @@ public:
     /** Collect all aspects used by the component and all its children */
     Aspects getUsedAspects () const;
     
+    /** Add all aspects used by the component and all its children to an existing set */
+    void collectUsedAspects (Aspects& answer) const;
+    
+    /** Change the identifier (use this rather than assigning, so UISpec indexes are kept valid) */
+    void setIdentifier (const ComponentID& n) { identifier = n; key = Symbol::intern (n); specEdited(); }
+    
     /** Make the component use a Positioner based on the given LayoutFrame */
-    void setLayout (const LayoutFrame& frame) { layout = LayoutSpec (frame); }
+    void setLayout (const LayoutFrame& frame) { layout = LayoutSpec (frame); specEdited(); }
+    
+    /** Make the component use a Positioner of any type, e.g. LayoutSpec::forFlexBox() or LayoutSpec::forGrid() */
+    void setLayout (const LayoutSpec& spec) { layout = spec; specEdited(); }
     
     /** Set whatever the component considers its label */
-    void setLabel (const String& l) { label = l; }
+    void setLabel (const String& l) { label = l; specEdited(); }
     
     /** Set a generic ARGB colour */
     void setColour (int identifier, const Colour& colour) { colours.add (identifier, colour); }
@@ -173,20 +212,27 @@ public:
     void setColour (int identifier, const Colour& colour, const String& source) { colours.add (identifier, colour, source); }
     
     /** Set the default aspect for bindings that require one but don't bother (this can be passed to the constructor already) */
-    void setAspect (Aspect a) { aspect = a; }
+    void setAspect (Aspect a) { aspect = a; specEdited(); }
+    
+    /** Set whether the component keeps its rendering in an image, e.g. for headers and frames that hardly ever change */
+    void setRenderCache (RenderCache::Policy policy) { renderCache = policy; specEdited(); }
     
     /** Add a component to the spec as a child and take ownership of it (compatibility mode) */
     ComponentSpec* addComponent (ComponentSpec* comp)
     {
         children.add (comp);
+        comp->setOwner (owner);
+        specEdited();
         return comp;
     }
     
     /** Add a component to the spec as a child and take ownership of it */
     ComponentSpec* addComponent (std::unique_ptr<ComponentSpec> comp)
     {
-        children.add (std::move(comp).get());
-        return comp.get();
+        auto child = children.add (comp.release());
+        child->setOwner (owner);
+        specEdited();
+        return child;
     }
 
     /** The spec takes ownership of the Binding */
@@ -198,6 +244,23 @@ public:
     /** Return true if the component can be populated with children that it will take ownership of */
     virtual bool isComposite() { return false; }
     
+    /** Return true if the component builds its children itself when needed, rather than UIBuilder up front */
+    virtual bool buildsChildrenOnDemand() const { return false; }
+    
+    /**
+     Any change to a spec tree must bump the edit version of its UISpec, which invalidates the
+     indexes it caches. Specs that don't belong to a UISpec yet, e.g. while a spec lambda builds
+     them, or temporary specs, have nothing to invalidate. Setters do this already, code that
+     modifies members directly must call this afterwards.
+     */
+    void specEdited();
+    
+    /** Attach this spec and all its children to the UISpec whose tree they are part of */
+    void setOwner (UISpec* uiSpec);
+    
+    /** The UISpec whose tree the spec is part of, or nullptr */
+    UISpec* getOwner() const { return owner; }
+    
     // ================= UIItemInterface Protocol ===============================
     
     const String getItemString() const override { return getClass()->getUserLabel(); }
@@ -213,16 +276,20 @@ public:
     
     UIComponentClass::Type type;
     ComponentID identifier;
+    SymbolID key;               ///< The identifier interned as Symbol, for fast lookup of adaptors
     String label;
     String tooltip;
     int focusOrder = 0;
     LayoutSpec layout;
     ColourSpec colours;
     Aspect aspect = Model::Undefined;
+    RenderCache::Policy renderCache = RenderCache::Policy::Never;
     OwnedArray<Binding> bindings;
     OwnedArray<ComponentSpec> children;
     
 private:
+    UISpec* owner = nullptr;
+    
     JUCE_LEAK_DETECTOR (ComponentSpec)
 };
 
@@ -750,6 +817,39 @@ public:
 
 //=====================================================================================================
 
+/**
+ Spec for UIVirtualForm, a scrolling form for thousands of rows. Populate it like a CompositeSpec,
+ typically using LayoutCursor::nextRow() and the like. Only the rows in view are built.
+ */
+class VirtualFormSpec : public CompositeSpecBase
+{
+public:
+    
+    METACLASS_BEGIN (VirtualFormSpec, CompositeSpecBase)
+    METACLASS_END
+    
+    VirtualFormSpec (const ComponentID& n, Aspect a = Model::Undefined) :
+        CompositeSpecBase (UIComponentClass::Type::VirtualForm, n, a)
+    {}
+    
+    std::unique_ptr<Component> buildInstance (std::shared_ptr<UIInstance> instance) const override;
+    
+    void generateSourceProperties (Model::Class* modelClass, SourceOutputStream& out) const override;
+    
+    bool buildsChildrenOnDemand() const override { return true; }
+    
+    /** Rows within this distance of the visible area are built in advance, so scrolling doesn't reveal gaps */
+    void setOverscan (int pixels) { overscan = pixels; specEdited(); }
+    
+    /** Maximum number of rows kept for reuse after they scrolled out of view */
+    void setCacheSize (int rows) { cacheSize = rows; specEdited(); }
+    
+    int overscan = 200;
+    int cacheSize = 64;
+};
+
+//=====================================================================================================
+
 /**
  Spec for arbitrary components that are created by user code
  */
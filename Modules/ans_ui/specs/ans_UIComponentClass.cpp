@@ -36,6 +36,7 @@ const Array<UIComponentClass> UIComponentClass::KnownClasses = {
     EC (EC::Type::Entry,        "Entry", {}),
     EC (EC::Type::Composite,    "Composite", {}),
     EC (EC::Type::Group,        "Group", {}),
+    EC (EC::Type::VirtualForm,  "VirtualForm", {}),
     EC (EC::Type::Tabs,         "Tabs", {}),
     EC (EC::Type::Concertina,   "Concertina", {}),
     EC (EC::Type::MenuBar,      "MenuBar", {}),
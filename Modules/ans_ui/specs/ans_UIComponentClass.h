@@ -57,6 +57,7 @@ struct UIComponentClass
         // Composites
         Composite,          // Groups multiple components for layout purposes
         Group,              // Groups multiple components for layout purposes, with a label and frame
+        VirtualForm,        // Scrolling composite that only builds the children in view
         Tabs,
         Concertina,
         MenuBar,
@@ -37,6 +37,11 @@ UISpec::UISpec (Model::Class* modelClassRef, std::unique_ptr<ComponentSpec> cont
 {
     // Temp specs are NOT registered globally
     rootSpec = std::move(content);
+    
+    if (rootSpec != nullptr)
+        rootSpec->setOwner (this);
+    
+    publishedSpec = rootSpec.get();
 }
 
 UISpec::~UISpec ()
@@ -46,14 +51,31 @@ UISpec::~UISpec ()
 
 void UISpec::flush ()
 {
+    const ScopedLock lock (specLock);
+    publishedSpec = nullptr;
     rootSpec = nullptr;
+    index.valid = false;
 }
 
 ComponentSpec* UISpec::getRootComponentSpec ()
 {
+    // Fast path once created, without taking the lock
+    if (auto spec = publishedSpec.load (std::memory_order_acquire))
+        return spec;
+    
+    const ScopedLock lock (specLock);
+    
     if (rootSpec == nullptr)
+    {
+        // Specs live as long as we do, so they must not come from the arena of an instance being built
+        UIArena::Scope heap (nullptr);
         rootSpec = createSpec();
-
+        
+        if (rootSpec != nullptr)
+            rootSpec->setOwner (this);
+        
+        publishedSpec.store (rootSpec.get(), std::memory_order_release);
+    }
     return rootSpec.get();
 }
 
@@ -70,43 +92,94 @@ std::unique_ptr<ComponentSpec> UISpec::createSpec ()
 
 Aspects UISpec::getUsedAspects ()
 {
-    if (auto spec = getRootComponentSpec())
-        return spec->getUsedAspects();
-    else
-        return Aspects();
-
+    const ScopedLock lock (specLock);
+    return getIndex().usedAspects;
 }
 
 ComponentSpec*  UISpec::getComponentSpec (const ComponentID& identifier)
 {
-    return findComponentSpec (identifier, getRootComponentSpec());
+    const ScopedLock lock (specLock);
+    return getIndex().specs[identifier];
 }
 
 const ComponentID  UISpec::getUniqueComponentID (const ComponentID& identifier, ComponentSpec* exclude)
 {
+    const ScopedLock lock (specLock);
+    auto& idx = getIndex();
+    
     ComponentID id = identifier;
     int iter = 0;
     
-    while (auto found = findComponentSpec (id, getRootComponentSpec(), exclude))
+    while (isIdentifierUsed (idx, id, exclude))
     {
         id = id.removeCharacters ("0123456789") + String(++iter);
     }
     return id;
 }
 
-ComponentSpec* UISpec::findComponentSpec (const ComponentID& identifier, ComponentSpec* current, ComponentSpec* exclude)
+int UISpec::getNumComponentsOfType (UIComponentClass::Type type)
 {
-    if (current == nullptr)
-        return nullptr;
+    const ScopedLock lock (specLock);
+    return getIndex().typeCounts[(int)type];
+}
+
+bool UISpec::isIdentifierUsed (Index& idx, const ComponentID& identifier, ComponentSpec* exclude)
+{
+    const int count = idx.identifierCounts[identifier];
     
-    if (current != exclude && current->identifier == identifier)
-        return current;
+    if (count == 0)
+        return false;
     
-    for (auto child : current->children)
-        if (auto found = findComponentSpec (identifier, child))
-            return found;
+    if (count > 1 || exclude == nullptr)
+        return true;
     
-    return nullptr;
+    return idx.specs[identifier] != exclude;
+}
+
+UISpec::Index& UISpec::getIndex ()
+{
+    // Caller must hold specLock
+    auto root = getRootComponentSpec();
+    
+    const auto version = getEditVersion();
+    
+    if (! index.valid || index.root != root || index.version != version)
+        index.build (root, version);
+    
+    return index;
+}
+
+void UISpec::Index::build (const ComponentSpec* rootSpec, uint32 editVersion)
+{
+    // The version is read before building, so concurrent edits invalidate us again
+    version = editVersion;
+    root = rootSpec;
+    
+    specs.clear();
+    identifierCounts.clear();
+    typeCounts.clear();
+    usedAspects = Aspects();
+    
+    if (root != nullptr)
+    {
+        add (root);
+        root->collectUsedAspects (usedAspects);
+    }
+    valid = true;
+}
+
+void UISpec::Index::add (const ComponentSpec* spec)
+{
+    const int count = identifierCounts[spec->identifier];
+    
+    if (count == 0)
+        specs.set (spec->identifier, const_cast<ComponentSpec*> (spec));
+    
+    identifierCounts.set (spec->identifier, count + 1);
+    typeCounts.set ((int)spec->type, typeCounts[(int)spec->type] + 1);
+    
+    for (auto child : spec->children)
+        add (child);
 }
 
 
@@ -195,5 +268,91 @@ void UISpecRegistry::collectGarbage()
 {
     specs.removeIf ([](auto& each) { return each.get() == nullptr; });
 }
+
+
+//==========================================================================================================
+#if 0
+#pragma mark UISpecPrewarmer
+#endif
+
+/** Creates the ComponentSpec of a single UISpec on a pool thread */
+
+class UISpecPrewarmer::Job : public ThreadPoolJob
+{
+public:
+    /**
+     The spec is resolved on the message thread in start(), since WeakReference must not be used on
+     other threads. A raw pointer is safe here: UISpecs live until UISpecRegistry is deleted, which
+     happens after we have removed all jobs.
+     */
+    Job (UISpec* s) : ThreadPoolJob ("Prewarm " + s->getName()), spec (s) {}
+    
+    JobStatus runJob() override
+    {
+        if (! shouldExit())
+            spec->getRootComponentSpec();
+        
+        return jobHasFinished;
+    }
+    
+private:
+    UISpec* const spec;
+};
+
+JUCE_IMPLEMENT_SINGLETON (UISpecPrewarmer)
+
+UISpecPrewarmer::UISpecPrewarmer ()
+{
+}
+
+UISpecPrewarmer::~UISpecPrewarmer ()
+{
+    // Created after UISpecRegistry, so we're deleted before any UISpec goes away
+    if (pool != nullptr)
+        pool->removeAllJobs (true, 2000);
+    
+    pool = nullptr;
+    clearSingletonInstance();
+}
+
+void UISpecPrewarmer::start (UISpec* preferred, int numThreads)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    
+    Array<UISpec*> queues[NumPriorities];
+    
+    UIModel::getMetaClass()->withAllSubClassesDo<UIModel::Class> ([&](UIModel::Class* modelClass)
+    {
+        for (auto spec : modelClass->getUISpecs())
+            if (! spec->isCreated())
+                queues[getPriority (spec, preferred)].addIfNotAlreadyThere (spec);
+    });
+    
+    if (pool == nullptr)
+        pool = std::make_unique<ThreadPool> (jmax (1, numThreads));
+    
+    // ThreadPool starts jobs in the order they were added
+    for (auto& queue : queues)
+        for (auto spec : queue)
+            pool->addJob (new Job (spec), true);
+}
+
+bool UISpecPrewarmer::isDone() const
+{
+    return pool == nullptr || pool->getNumJobs() == 0;
+}
+
+UISpecPrewarmer::Priority UISpecPrewarmer::getPriority (UISpec* spec, UISpec* preferred)
+{
+    if (spec == preferred)
+        return Preferred;
+    
+    if (! spec->isDefault())
+        return Other;
+    
+    return dynamic_cast<WindowUIModel::Class*>(spec->getModelClass()) != nullptr
+        ? WindowDefault
+        : EmbeddedDefault;
+}
     
 }
@@ -41,15 +41,26 @@ public:
     const String& getName() const { return specName; }
     Model::Class* getModelClass() const { return modelClass; }
     
+    /** Find a ComponentSpec by identifier (the first one in tree order, if there are duplicates) */
     ComponentSpec*  getComponentSpec (const ComponentID& identifier);
+    
+    /** Derive an identifier from the one given that is not yet used by any spec other than exclude */
     const String  getUniqueComponentID (const ComponentID& identifier, ComponentSpec* exclude = nullptr);
     
+    /** Count the components of a particular type in this UI */
+    int getNumComponentsOfType (UIComponentClass::Type type);
+    
     /**
      Return the ComponentSpec provided by this UISpec. This may be a WindowSpec or a CompositeSpec,
-     depending on whether this is for a window, or for an embedded UI
+     depending on whether this is for a window, or for an embedded UI. The spec is created lazily
+     and this is safe to call from any thread: concurrent callers block until the first one has
+     finished creating it, so the spec lambda is evaluated only once.
      */
     ComponentSpec* getRootComponentSpec ();
     
+    /** Whether the ComponentSpec has already been created, without creating it */
+    bool isCreated() const { return publishedSpec.load() != nullptr; }
+    
     /** Generate C++ source code for the .specs.cpp file of the model */
     String generateSourceCPP (Model::Class* modelClass);
     
@@ -65,17 +76,46 @@ public:
     /** Delete any chached ComponentSpec */
     void flush();
     
+    /** Called by the specs of the tree whenever they were edited, which invalidates the index */
+    void specEdited() { ++editVersion; }
+    
+    /** Current edit version, see specEdited() */
+    uint32 getEditVersion() const { return editVersion.load(); }
+    
     /** Render the name for display in lists & trees */
     const String getItemString() const override { return getName(); }
 
 private:
+    /**
+     Lookup tables derived from the spec tree. They are built lazily on first use and rebuilt
+     whenever getEditVersion() has moved on, i.e. after the spec was edited.
+     */
+    struct Index
+    {
+        void build (const ComponentSpec* root, uint32 editVersion);
+        void add (const ComponentSpec* spec);
+        
+        const ComponentSpec* root = nullptr;
+        uint32 version = 0;
+        bool valid = false;
+        HashMap<ComponentID, ComponentSpec*> specs;
+        HashMap<ComponentID, int> identifierCounts;
+        HashMap<int, int> typeCounts;
+        Aspects usedAspects;
+    };
+    
     std::unique_ptr<ComponentSpec> createSpec ();
-    ComponentSpec* findComponentSpec (const ComponentID& identifier, ComponentSpec* current, ComponentSpec* exclude = nullptr);
+    Index& getIndex ();
+    bool isIdentifierUsed (Index& index, const ComponentID& identifier, ComponentSpec* exclude);
     
     Model::Class* modelClass;
     String specName;
     SpecLambda specLambda;
     std::unique_ptr<ComponentSpec> rootSpec;
+    std::atomic<ComponentSpec*> publishedSpec { nullptr };
+    std::atomic<uint32> editVersion { 0 };
+    CriticalSection specLock;
+    Index index;
     File filename;
     bool defaultSpec;
     
@@ -109,4 +149,54 @@ private:
 };
 
 
+/**
+ UISpecPrewarmer evaluates the spec lambdas of all known UISpec on a small background thread pool,
+ so that opening a window or populating a tab does not have to construct its ComponentSpec tree on
+ the message thread first. Specs are queued by priority: the preferred spec (usually the main
+ window's default spec) first, then default specs of WindowUIModels, then other default specs and
+ finally everything else. If the message thread asks for a spec that is still being created, it
+ simply waits for that job to finish.
+ 
+ Spec lambdas only create specs, bindings and layouts, so they can run off the message thread.
+ Don't touch Components or other message-thread-only objects in hand-written spec lambdas.
+ */
+
+class UISpecPrewarmer :
+        public DeletedAtShutdown
+{
+public:
+    enum Priority
+    {
+        Preferred = 0,
+        WindowDefault,
+        EmbeddedDefault,
+        Other,
+        NumPriorities
+    };
+    
+    UISpecPrewarmer ();
+   ~UISpecPrewarmer ();
+    
+    /**
+     Walk all subclasses of UIModel and queue their specs for background creation. Must be called
+     on the message thread, usually from JUCEApplication::initialise() before opening the first window.
+     */
+    void start (UISpec* preferred = nullptr, int numThreads = 2);
+    
+    /** Whether all queued specs have been created */
+    bool isDone() const;
+    
+    /** Return the priority at which a spec would be queued */
+    static Priority getPriority (UISpec* spec, UISpec* preferred);
+    
+    JUCE_DECLARE_SINGLETON (UISpecPrewarmer, true)
+    
+private:
+    class Job;
+    std::unique_ptr<ThreadPool> pool;
+    
+    JUCE_DECLARE_NON_COPYABLE (UISpecPrewarmer)
+};
+
+
 }
@@ -0,0 +1,253 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_AnchorSolver.h"
+#include "ans_Positioners.h"
+
+namespace ans {
+    using namespace juce;
+
+namespace AnchorHelpers
+{
+    /** Call f for each sibling a frame is anchored to */
+    template <typename Function>
+    void forEachAnchor (const LayoutFrame& frame, Function&& f)
+    {
+        for (auto side : { &frame.left, &frame.top, &frame.right, &frame.bottom })
+            if (side->isAnchored())
+                f (side->anchor);
+    }
+    
+    /**
+     Kahn's algorithm: returns the indexes in topological order, followed by the indexes that
+     are part of (or depend on) a cycle, the number of which is returned in numCyclic.
+     */
+    Array<int> sortTopologically (const Array<Array<int>>& dependents, const Array<int>& numAnchors, int& numCyclic)
+    {
+        Array<int> order, remaining (numAnchors);
+        
+        for (int i = 0; i < remaining.size(); ++i)
+            if (remaining[i] == 0)
+                order.add (i);
+        
+        for (int n = 0; n < order.size(); ++n)
+            for (auto d : dependents.getReference (order[n]))
+                if (--remaining.getReference (d) == 0)
+                    order.add (d);
+        
+        numCyclic = remaining.size() - order.size();
+        
+        for (int i = 0; i < remaining.size(); ++i)
+            if (remaining[i] > 0)
+                order.add (i);
+        
+        return order;
+    }
+}
+
+//==========================================================================================================
+#if 0
+#pragma mark AnchorSolver
+#endif
+
+AnchorSolver::AnchorSolver (Component& p) :
+    parent (p)
+{
+}
+
+void AnchorSolver::layout (FramePositioner& positioner, const Rectangle<int>& parentBounds)
+{
+    if (! built)
+        rebuild();
+    
+    int index = -1;
+    for (int i = 0; i < nodes.size(); ++i)
+        if (nodes.getReference (i).positioner == &positioner)
+            index = i;
+    
+    if (index < 0)
+    {
+        positioner.applyResolvedBounds (positioner.frame.rectangleRelativeTo (parentBounds));
+        return;
+    }
+    
+    const Point<int> size (parentBounds.getWidth(), parentBounds.getHeight());
+    
+    if (size != solvedSize)
+    {
+        solveAll (parentBounds);
+        solvedSize = size;
+    }
+    else
+        solveFrom (index, parentBounds);
+}
+
+void AnchorSolver::rebuild ()
+{
+    nodes.clearQuick();
+    keys.clear();
+    
+    Array<Node> found;
+    for (auto child : parent.getChildren())
+        if (auto positioner = dynamic_cast<FramePositioner*> (child->getPositioner()))
+        {
+            Node node;
+            node.component = child;
+            node.positioner = positioner;
+            // Siblings can only be anchored to names that are Symbols already
+            node.key = Symbol::find (child->getComponentID());
+            found.add (node);
+        }
+    
+    HashMap<SymbolID, int> foundKeys;
+    for (int i = 0; i < found.size(); ++i)
+        if (found.getReference (i).key != 0)
+            foundKeys.set (found.getReference (i).key, i);
+    
+    Array<Array<int>> dependents;
+    Array<int> numAnchors;
+    dependents.resize (found.size());
+    numAnchors.resize (found.size());
+    
+    for (int i = 0; i < found.size(); ++i)
+        AnchorHelpers::forEachAnchor (found.getReference (i).positioner->frame, [&] (SymbolID anchor)
+        {
+            if (foundKeys.contains (anchor))
+            {
+                dependents.getReference (foundKeys[anchor]).add (i);
+                numAnchors.getReference (i)++;
+            }
+        });
+    
+    int numCyclic = 0;
+    auto order = AnchorHelpers::sortTopologically (dependents, numAnchors, numCyclic);
+    
+    if (numCyclic > 0)
+        DBG ("*** ERROR: Anchors of " << numCyclic << " children of " << parent.getComponentID().quoted() << " form a cycle and are ignored");
+    
+    // Renumber in topological order
+    Array<int> position;
+    position.resize (found.size());
+    for (int n = 0; n < order.size(); ++n)
+        position.set (order[n], n);
+    
+    for (int n = 0; n < order.size(); ++n)
+    {
+        Node node = found.getReference (order[n]);
+        node.cyclic = n >= order.size() - numCyclic;
+        
+        for (auto d : dependents.getReference (order[n]))
+            node.dependents.add (position[d]);
+        
+        if (node.key != 0)
+            keys.set (node.key, n);
+        
+        nodes.add (node);
+    }
+    
+    built = true;
+    solvedSize = { -1, -1 };
+}
+
+Rectangle<int> AnchorSolver::resolve (const Node& node, const Rectangle<int>& parentBounds) const
+{
+    const auto& frame = node.positioner->frame;
+    
+    if (node.cyclic)
+        return frame.rectangleRelativeTo (parentBounds);
+    
+    // Siblings we are anchored to were resolved before us
+    return frame.rectangleRelativeTo (parentBounds, [this] (SymbolID anchor) -> const Rectangle<int>*
+    {
+        if (keys.contains (anchor))
+            return &nodes.getReference (keys[anchor]).rect;
+        return nullptr;
+    });
+}
+
+void AnchorSolver::solveAll (const Rectangle<int>& parentBounds)
+{
+    for (auto& node : nodes)
+    {
+        node.rect = resolve (node, parentBounds);
+        node.pending = false;
+        node.positioner->applyResolvedBounds (node.rect);
+    }
+}
+
+void AnchorSolver::solveFrom (int index, const Rectangle<int>& parentBounds)
+{
+    nodes.getReference (index).pending = true;
+    
+    // Dependents always come later in topological order
+    for (int i = index; i < nodes.size(); ++i)
+    {
+        auto& node = nodes.getReference (i);
+        if (! node.pending)
+            continue;
+        
+        node.pending = false;
+        auto rect = resolve (node, parentBounds);
+        
+        if (rect != node.rect)
+        {
+            node.rect = rect;
+            for (auto d : node.dependents)
+                nodes.getReference (d).pending = true;
+        }
+        node.positioner->applyResolvedBounds (rect);
+    }
+}
+
+bool AnchorSolver::validate (const Array<std::pair<SymbolID, LayoutFrame>>& siblings, String& problem)
+{
+    HashMap<SymbolID, int> keys;
+    for (int i = 0; i < siblings.size(); ++i)
+        if (siblings.getReference (i).first != 0)
+            keys.set (siblings.getReference (i).first, i);
+    
+    Array<Array<int>> dependents;
+    Array<int> numAnchors;
+    dependents.resize (siblings.size());
+    numAnchors.resize (siblings.size());
+    StringArray unknown;
+    
+    for (int i = 0; i < siblings.size(); ++i)
+        AnchorHelpers::forEachAnchor (siblings.getReference (i).second, [&] (SymbolID anchor)
+        {
+            if (keys.contains (anchor))
+            {
+                dependents.getReference (keys[anchor]).add (i);
+                numAnchors.getReference (i)++;
+            }
+            else
+                unknown.addIfNotAlreadyThere (Symbol (anchor).toString());
+        });
+    
+    int numCyclic = 0;
+    auto order = AnchorHelpers::sortTopologically (dependents, numAnchors, numCyclic);
+    
+    problem.clear();
+    
+    if (unknown.size() > 0)
+        problem << "Anchored to unknown siblings: " << unknown.joinIntoString (", ") << ". ";
+    
+    if (numCyclic > 0)
+    {
+        StringArray cycle;
+        for (int n = order.size() - numCyclic; n < order.size(); ++n)
+            cycle.add (Symbol (siblings.getReference (order[n]).first).toString());
+        
+        problem << "Anchors form a cycle: " << cycle.joinIntoString (", ") << ".";
+    }
+    
+    return problem.isEmpty();
+}
+
+}
@@ -0,0 +1,87 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "ans_LayoutFrame.h"
+
+namespace ans {
+    using namespace juce;
+
+struct FramePositioner;
+
+/**
+ AnchorSolver lays out the frame-positioned children of a component, some of which have sides
+ anchored to their siblings (e.g. "@label.right + 4"). The children are kept in topological order,
+ so every frame is resolved after the siblings it refers to. When the parent's size changes, all
+ frames are resolved in one sweep. Otherwise only the child that asked and whatever depends on it
+ are resolved again, and propagation stops at frames whose rectangle didn't change.
+ 
+ Children that are part of a cycle are resolved without their anchors. Cycles should be caught
+ when the spec is built though, see validate().
+ */
+
+class AnchorSolver
+{
+public:
+    
+    /** Implemented by components that lay out anchored children, e.g. UIComposite */
+    struct Host
+    {
+        virtual ~Host() {}
+        
+        /** Return the solver for the children, creating it only if asked to */
+        virtual AnchorSolver* getAnchorSolver (bool create) = 0;
+    };
+    
+    AnchorSolver (Component& parent);
+    
+    /** Lay out the child of a positioner, along with any siblings that depend on it */
+    void layout (FramePositioner& positioner, const Rectangle<int>& parentBounds);
+    
+    /** Collect the children again before the next layout, since they or their positioners changed */
+    void invalidate () { built = false; }
+    
+    /**
+     Check the frames of siblings for anchors to unknown siblings and for cycles. Returns true if
+     the frames can be resolved, or else false along with a description of the problem.
+     */
+    static bool validate (const Array<std::pair<SymbolID, LayoutFrame>>& siblings, String& problem);
+    
+private:
+    
+    struct Node
+    {
+        Component* component;
+        FramePositioner* positioner;
+        SymbolID key;
+        Array<int> dependents;      // Indexes of nodes anchored to this one
+        Rectangle<int> rect;
+        bool cyclic = false;
+        bool pending = false;
+    };
+    
+    /** Collect the children and sort them topologically */
+    void rebuild ();
+    
+    Rectangle<int> resolve (const Node& node, const Rectangle<int>& parentBounds) const;
+    void solveAll (const Rectangle<int>& parentBounds);
+    void solveFrom (int index, const Rectangle<int>& parentBounds);
+    
+    Component& parent;
+    Array<Node> nodes;          // In topological order
+    HashMap<SymbolID, int> keys;
+    bool built = false;
+    Point<int> solvedSize { -1, -1 };
+    
+    JUCE_DECLARE_NON_COPYABLE (AnchorSolver)
+};
+
+}
@@ -8,45 +8,48 @@
  */
 
 #include "ans_LayoutFrame.h"
+#include "ans_SourceOutputStream.h"
 
 namespace ans {
     using namespace juce;
 
-namespace SideHelpers
+const StringArray LayoutFrame::Side::EdgeNames = {
+    "left",
+    "top",
+    "right",
+    "bottom",
+    "centreX",
+    "centreY"
+};
+
+LayoutFrame::Side LayoutFrame::Side::anchoredTo (const String& sibling, Edge edge, int offset, Range<int> limits)
+{
+    Side s (0.0f, offset, limits, false);
+    s.anchor = Symbol::intern (sibling);
+    s.anchorEdge = edge;
+    return s;
+}
+
+int LayoutFrame::Side::getEdge (const Rectangle<int>& rect, Edge edge)
 {
-    struct Parser
+    switch (edge)
     {
-        Parser (const String& source) :
-            input(source),
-            position(0),
-            size((int)source.getNumBytesAsUTF8())
-        {}
-        
-        bool atEnd() { return position > size; }
-        bool isNumeric (char c) { return (c >= '0' && c <= '9') || c == '+' || c == '-'; }
-        
-        inline char peek() { return input[position]; }
-        inline char next() { position++; return input[position-1]; }
-        
-        bool readNumber (int& n)
-        {
-            int a = position;
-            while ( isNumeric (peek()) )
-                next();
-            if (position > a)
-            {
-                n = input.substring (a, position).getIntValue();
-                return true;
-            }
-            return false;
-        }
-        
-        const String input;
-        int position;
-        int size;
-    };
+        case Edge::left:    return rect.getX();
+        case Edge::top:     return rect.getY();
+        case Edge::right:   return rect.getRight();
+        case Edge::bottom:  return rect.getBottom();
+        case Edge::centreX: return rect.getCentreX();
+        case Edge::centreY: return rect.getCentreY();
+    }
+    return 0;
 }
 
+int LayoutFrame::Side::relativeToAnchor (int length, const Rectangle<int>& sibling) const
+{
+    // Anchors have no fraction, and limits apply to the final position like for any other side
+    ignoreUnused (length);
+    return limits.clipValue (getEdge (sibling, anchorEdge) + offset);
+}
 
 int LayoutFrame::Side::relativeToParent (int length, int opposite) const
 {
@@ -75,16 +78,22 @@ String LayoutFrame::Side::print() const
     String out;
     LayoutFrame::Side standard;
     
+    if (isAnchored())
+    {
+        standard = Side (0.0f, 0, Range<int> (INT_MIN, INT_MAX), false);
+        out << "@" << Symbol (anchor).toString() << "." << EdgeNames[(int)anchorEdge];
+    }
+    
     if (fraction != standard.fraction)
         out << roundToInt(fraction * 100) << "%";
 
-    if (offset != standard.offset || fraction == standard.fraction)
+    if (offset != standard.offset || (fraction == standard.fraction && ! isAnchored()))
         out << (out.isNotEmpty() ? " ":"") << (offset < 0 ? (out.isEmpty() ? "-" : "- ") : (out.isEmpty() ? "" : "+ ")) << abs(offset);
 
     if (limits != standard.limits)
         out << (out.isNotEmpty() ? " ":"") << "[" << limits.getStart() << ".." << limits.getEnd() << "]";
     
-    if (relative)
+    if (relative && ! isAnchored())
         out << " relative";
     
     return out;
@@ -98,34 +107,72 @@ void LayoutFrame::Side::parse (const String& source)
     // "22 relative"
     // "12%-2 relative"
     
-    offset = 0;
-    fraction = 0;
-    relative = false;
-    limits = {0, INT_MAX};
+    // "@label.right + 4", "@title.bottom [0..200]"
+    auto text = source.trim();
     
-    SideHelpers::Parser p (source.removeCharacters(" "));
-    int n;
-    if (p.readNumber (n))
+    if (text.startsWithChar ('@'))
     {
-        if (p.peek() == '%')
+        auto reference = text.substring (1).initialSectionContainingOnly ("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.");
+        auto sibling = reference.upToFirstOccurrenceOf (".", false, false);
+        auto edgeName = reference.fromFirstOccurrenceOf (".", false, false);
+        auto rest = text.substring (1 + reference.length());
+        
+        int edge = EdgeNames.indexOf (edgeName, true);
+        if (edgeName.equalsIgnoreCase ("baseline"))
+            edge = (int)Edge::bottom;   // Close enough for labels of equal height
+        
+        if (sibling.isEmpty() || edge < 0)
         {
-            fraction = 0.01f * n;
-            p.next();
-        } else
-            offset = n;
+            DBG ("*** ERROR: Invalid anchor " << text.quoted());
+            edge = (int)Edge::left;
+        }
         
-        if (p.readNumber (n))
-            offset = n;
-
-        if (p.peek() == '[')
+        // The offset and the limits are both optional, so they are parsed independently
+        auto offsetText = rest.upToFirstOccurrenceOf ("[", false, false);
+        auto offset = parsed (offsetText.toRawUTF8(), offsetText.getNumBytesAsUTF8()).offset;
+        Range<int> limits (INT_MIN, INT_MAX);
+        
+        if (rest.containsChar ('['))
         {
-            p.next();
-            if (p.readNumber(n)) limits.setStart(n);
-            while (p.peek() == '.') p.next();
-            if (p.readNumber(n)) limits.setEnd(n);
+            auto bounds = rest.fromFirstOccurrenceOf ("[", false, false).upToFirstOccurrenceOf ("]", false, false);
+            auto lo = bounds.upToFirstOccurrenceOf ("..", false, false).trim();
+            auto hi = bounds.fromFirstOccurrenceOf ("..", false, false).trim();
+            limits = Range<int> (lo.isEmpty() ? INT_MIN : lo.getIntValue(),
+                                 hi.isEmpty() ? INT_MAX : hi.getIntValue());
         }
+        
+        *this = anchoredTo (sibling, (Edge)edge, offset, limits);
+        return;
     }
-    relative = source.indexOfIgnoreCase ("rel") > 0;
+    
+    *this = parsed (source.toRawUTF8(), source.getNumBytesAsUTF8());
+}
+
+String LayoutFrame::Side::generateSourceCPP() const
+{
+    String out;
+    
+    if (isAnchored())
+    {
+        out << "LayoutFrame::Side::anchoredTo (" << Symbol (anchor).toString().quoted()
+            << ", LayoutFrame::Side::Edge::" << EdgeNames[(int)anchorEdge]
+            << ", " << offset;
+        
+        if (limits != Range<int> (INT_MIN, INT_MAX))
+            out << ", {" << limits.getStart() << ", " << limits.getEnd() << "}";
+        
+        out << ")";
+        return out;
+    }
+    
+    out << "LayoutFrame::Side (" << SourceOutputStream::floatLiteral (fraction) << ", " << offset;
+    
+    if (! hasDefaultLimits() || relative)
+        out << ", {" << limits.getStart() << ", " << (limits.getEnd() == INT_MAX ? String ("INT_MAX") : String (limits.getEnd())) << "}, "
+            << (relative ? "true" : "false");
+    
+    out << ")";
+    return out;
 }
 
 bool LayoutFrame::Side::operator== (const Side& other) const
@@ -133,7 +180,9 @@ bool LayoutFrame::Side::operator== (const Side& other) const
     return fraction == other.fraction
         && offset == other.offset
         && limits == other.limits
-        && relative == other.relative;
+        && relative == other.relative
+        && anchor == other.anchor
+        && (anchor == 0 || anchorEdge == other.anchorEdge);
 }
 
 bool LayoutFrame::operator== (const LayoutFrame& other) const
@@ -158,12 +207,28 @@ String LayoutFrame::generateSourceCPP() const
         return "LayoutFrame::entire()";
         
     String out;
-    out << "LayoutFrame("
-        << left.print().quoted() << ", "
-        << top.print().quoted() << ", "
-        << right.print().quoted() << ", "
-        << bottom.print().quoted() << ")";
+    const Side* sides[] = { &left, &top, &right, &bottom };
+    bool simple = true;
+    
+    for (auto side : sides)
+        simple = simple && side->hasDefaultLimits() && ! side->relative && ! side->isAnchored();
     
+    if (simple)
+    {
+        // Fractions and offsets only
+        out << "LayoutFrame(";
+        for (auto side : sides)
+            out << (side != sides[0] ? ", " : "") << SourceOutputStream::floatLiteral (side->fraction) << ", " << side->offset;
+        out << ")";
+    }
+    else
+    {
+        out << "LayoutFrame("
+            << left.generateSourceCPP() << ", "
+            << top.generateSourceCPP() << ", "
+            << right.generateSourceCPP() << ", "
+            << bottom.generateSourceCPP() << ")";
+    }
     return out;
 }
 
@@ -23,22 +23,43 @@ struct LayoutFrame
 {
     struct Side
     {
-        Side () :
+        /** Edges of a sibling a side can be anchored to */
+        enum class Edge
+        {
+            left = 0,
+            top,
+            right,
+            bottom,
+            centreX,
+            centreY
+        };
+        
+        /** Names of edges in anchor expressions, in order of Edge */
+        static const StringArray EdgeNames;
+        
+        constexpr Side () :
             fraction (0),
             offset (0),
             limits (0, INT_MAX),
             relative (false)
         {}
         
-        Side (float f, int o) :
+        constexpr Side (float f, int o) :
             fraction (f),
             offset (o),
             limits (0, INT_MAX),
             relative (false)
         {}
         
+        constexpr Side (float f, int o, Range<int> l, bool rel) :
+            fraction (f),
+            offset (o),
+            limits (l),
+            relative (rel)
+        {}
+        
         /** This constructor interprets f <= 1.0 as fractional, or offset else */
-        Side (float f) :
+        constexpr Side (float f) :
             fraction (f <= 1.0 ? f : 0),
             offset   (f >  1.0 ? f : 0),
             limits (0, INT_MAX),
@@ -54,6 +75,13 @@ struct LayoutFrame
             return s;
         }
         
+        /**
+         Construct a Side anchored to an edge of a sibling, identified by its component ID. The offset
+         is added to the position of that edge (in parent coordinates), then limits are applied. This
+         is what "@label.right + 4" parses to.
+         */
+        static Side anchoredTo (const String& sibling, Edge edge, int offset = 0, Range<int> limits = Range<int> (INT_MIN, INT_MAX));
+        
         static Side fromString (const String& source)
         {
             Side s;
@@ -61,14 +89,70 @@ struct LayoutFrame
             return s;
         }
         
+        /**
+         Parse a side expression at compile time, e.g. Side::parsed ("50% - 450 [100..1200]").
+         This accepts the same syntax as parse() and the _side literal is a shorthand for it,
+         except for anchors to siblings, which are only known at runtime.
+         */
+        static constexpr Side parsed (const char* source, size_t length)
+        {
+            size_t i = 0;
+            int n = 0;
+            float f = 0;
+            int o = 0;
+            int lo = 0, hi = INT_MAX;
+            
+            if (readNumber (source, length, i, n))
+            {
+                if (peek (source, length, i) == '%')
+                {
+                    f = 0.01f * n;
+                    i++;
+                } else
+                    o = n;
+                
+                if (readNumber (source, length, i, n))
+                    o = n;
+                
+                if (peek (source, length, i) == '[')
+                {
+                    i++;
+                    if (readNumber (source, length, i, n)) lo = n;
+                    while (peek (source, length, i) == '.') i++;
+                    if (readNumber (source, length, i, n)) hi = n;
+                }
+            }
+            return Side (f, o, Range<int> (lo, hi), containsRelative (source, length));
+        }
+        
+        static constexpr Side parsed (const char* source)
+        {
+            size_t length = 0;
+            while (source[length] != 0)
+                length++;
+            return parsed (source, length);
+        }
+        
         /** Maps a single side relative to a parent rectangle according to the side's specs */
         int relativeToParent (int parent, int opposite) const;
+        
+        /** Maps an anchored side, given the rectangle of the sibling it is anchored to */
+        int relativeToAnchor (int parent, const Rectangle<int>& sibling) const;
+        
+        /** Position of an edge of a rectangle */
+        static int getEdge (const Rectangle<int>& rect, Edge edge);
                 
         String print() const;
         void parse (const String& source);
         
-        bool isNotDefault() const { return fraction != 0.0 || offset != 0 || relative; }
+        /** For use in C++ expressions, in numeric form that needs no parsing */
+        String generateSourceCPP() const;
+        
+        bool hasDefaultLimits() const { return limits == Range<int> (0, INT_MAX); }
+        
+        bool isNotDefault() const { return fraction != 0.0 || offset != 0 || relative || anchor != 0; }
         bool isRelative() const { return relative; }
+        bool isAnchored() const { return anchor != 0; }
         
         bool operator== (const Side& other) const;
         bool operator!= (const Side& other) const { return !(*this == other); }
@@ -78,9 +162,62 @@ struct LayoutFrame
         int offset;         // absolute offset from that (negative/positive)
         Range<int> limits;  // absolute limits on the final value
         bool relative;      // if true, expression is relative to opposing side
+        SymbolID anchor = 0;            // component ID of a sibling, if anchored
+        Edge anchorEdge = Edge::left;   // edge of that sibling
+        
+    private:
+        // Helpers for parsed(), which ignore blanks anywhere
+        
+        static constexpr char peek (const char* s, size_t length, size_t& i)
+        {
+            while (i < length && s[i] == ' ')
+                i++;
+            return i < length ? s[i] : 0;
+        }
+        
+        static constexpr bool isNumeric (char c) { return (c >= '0' && c <= '9') || c == '+' || c == '-'; }
+        
+        /** Reads a run of digits and signs, then evaluates it like String::getIntValue() */
+        static constexpr bool readNumber (const char* s, size_t length, size_t& i, int& n)
+        {
+            bool found = false, started = false, negative = false, done = false;
+            int value = 0;
+            
+            while (isNumeric (peek (s, length, i)))
+            {
+                const char c = s[i++];
+                found = true;
+                
+                if (done)
+                    continue;
+                
+                if (c >= '0' && c <= '9')
+                    value = value * 10 + (c - '0');
+                else if (! started)
+                    negative = (c == '-');
+                else
+                    done = true;
+                
+                started = true;
+            }
+            if (found)
+                n = negative ? -value : value;
+            return found;
+        }
+        
+        static constexpr char lower (char c) { return (c >= 'A' && c <= 'Z') ? char (c + ('a' - 'A')) : c; }
+        
+        /** "rel" anywhere but at the very start */
+        static constexpr bool containsRelative (const char* s, size_t length)
+        {
+            for (size_t i = 1; i + 2 < length; ++i)
+                if (lower (s[i]) == 'r' && lower (s[i + 1]) == 'e' && lower (s[i + 2]) == 'l')
+                    return true;
+            return false;
+        }
     };
     
-    LayoutFrame () :
+    constexpr LayoutFrame () :
         left   (0.0, 0),
         top    (0.0, 0),
         right  (0.0, 0),
@@ -95,14 +232,13 @@ struct LayoutFrame
         bottom (0, rect.getBottomRight().y)
     {}
     
-    /**
-    LayoutFrame (Side leftSide, Side topSide, Side rightSide, Side bottomSide) :
+    constexpr LayoutFrame (Side leftSide, Side topSide, Side rightSide, Side bottomSide) :
         left   (leftSide),
         top    (topSide),
         right  (rightSide),
         bottom (bottomSide)
     {}
-    */
+    
     LayoutFrame (const String& leftSide, const String& topSide, const String& rightSide, const String& bottomSide) :
         left   (Side::fromString(leftSide)),
         top    (Side::fromString(topSide)),
@@ -110,7 +246,7 @@ struct LayoutFrame
         bottom (Side::fromString(bottomSide))
     {}
 
-    LayoutFrame (float leftFraction,   int leftOffset,
+    constexpr LayoutFrame (float leftFraction,   int leftOffset,
                  float topFraction,    int topOffset,
                  float rightFraction,  int rightOffset,
                  float bottomFraction, int bottomOffset) :
@@ -120,7 +256,7 @@ struct LayoutFrame
         bottom (bottomFraction, bottomOffset)
     {}
     
-    LayoutFrame (float leftF, float topF, float rightF, float bottomF) :
+    constexpr LayoutFrame (float leftF, float topF, float rightF, float bottomF) :
         left   (leftF),
         top    (topF),
         right  (rightF),
@@ -130,9 +266,25 @@ struct LayoutFrame
     /** Creates a LayoutFrame that maps to the entire area of the parent */
     static LayoutFrame entire();
     
+    bool hasAnchors () const { return left.isAnchored() || top.isAnchored() || right.isAnchored() || bottom.isAnchored(); }
+    
     bool hasRelativeWidth ()  const { return right.isRelative(); }
     bool hasRelativeHeight()  const { return bottom.isRelative(); }
     
+    /** Whether top and bottom resolve to the same values no matter the size of the parent or siblings */
+    bool hasConstantVerticalExtent() const
+    {
+        return top.fraction == 0.0f && ! top.relative && ! top.isAnchored()
+            && bottom.fraction == 0.0f && ! bottom.isAnchored();
+    }
+    
+    /** Top and bottom of a frame that hasConstantVerticalExtent() */
+    Range<int> getConstantVerticalExtent() const
+    {
+        const int y1 = top.relativeToParent (0, 0);
+        return Range<int> (y1, jmax (y1, bottom.relativeToParent (0, y1)));
+    }
+    
     bool isNotDefault()   const
     {
         return left.isNotDefault() || top.isNotDefault() || right.isNotDefault() || bottom.isNotDefault();
@@ -144,6 +296,31 @@ struct LayoutFrame
     /** Maps the rectangle relative to a parent rectangle according to the frame's specs */
     Rectangle<int> rectangleRelativeTo (const Rectangle<int>& parent) const;
     
+    /**
+     Like rectangleRelativeTo(), but anchored sides are resolved against their siblings. The lookup
+     returns a pointer to the rectangle of the sibling with a given SymbolID, or nullptr if it is
+     unknown, in which case the side is resolved as if it were anchored to the parent's origin.
+     */
+    template <typename SiblingLookup>
+    Rectangle<int> rectangleRelativeTo (const Rectangle<int>& parent, SiblingLookup&& lookup) const
+    {
+        auto map = [&] (const Side& side, int length, int opposite)
+        {
+            if (side.isAnchored())
+                if (const Rectangle<int>* sibling = lookup (side.anchor))
+                    return side.relativeToAnchor (length, *sibling);
+            
+            return side.relativeToParent (length, opposite);
+        };
+        
+        int x1 = map (left,   parent.getWidth(),  0);
+        int y1 = map (top,    parent.getHeight(), 0);
+        int x2 = map (right,  parent.getWidth(),  x1);
+        int y2 = map (bottom, parent.getHeight(), y1);
+        
+        return Rectangle<int> (Point<int> (x1, y1), Point<int> (jmax (x1, x2), jmax (y1, y2)));
+    }
+    
     /** Returns a version of this frame with a fixed width. */
     LayoutFrame withFixedWidth  (int w) const { auto f = LayoutFrame (*this); f.right = Side::off(w); return f; }
     
@@ -174,11 +351,17 @@ struct LayoutFrame
     /** Returns a version of this rectangle with the given amount removed from its bottom edge. */
     LayoutFrame withTrimmedBottom (int amount) const { return withBottom ({bottom.fraction, bottom.offset - amount}); }
     
-    /** For use in C++ expressions */
+    /** For use in C++ expressions, in numeric form so that constructing the frame needs no parsing */
     String generateSourceCPP () const;
     
     // Member Variables
     Side left, top, right, bottom;
 };
 
+/** Compile-time side expression, e.g. LayoutFrame ("100% - 88"_side, "4"_side, "40 relative"_side, "16 relative"_side) */
+constexpr LayoutFrame::Side operator"" _side (const char* source, size_t length)
+{
+    return LayoutFrame::Side::parsed (source, length);
+}
+
 }
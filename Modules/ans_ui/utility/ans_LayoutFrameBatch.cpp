@@ -0,0 +1,164 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_LayoutFrameBatch.h"
+
+namespace ans {
+    using namespace juce;
+
+//==========================================================================================================
+#if 0
+#pragma mark LayoutFrameBatch
+#endif
+
+void LayoutFrameBatch::SideArrays::clear ()
+{
+    fraction.clearQuick();
+    offset.clearQuick();
+    minimum.clearQuick();
+    maximum.clearQuick();
+    relative.clearQuick();
+}
+
+void LayoutFrameBatch::SideArrays::add (const LayoutFrame::Side& side)
+{
+    fraction.add (side.fraction);
+    offset.add ((float) side.offset);
+    minimum.add ((float) side.limits.getStart());
+    maximum.add ((float) side.limits.getEnd());
+    relative.add (side.relative ? 1.0f : 0.0f);
+}
+
+void LayoutFrameBatch::SideArrays::resolve (float* dest, float length, const float* opposite, int num) const
+{
+    // limits.clipValue ((fraction * length) + offset)
+    FloatVectorOperations::copyWithMultiply (dest, fraction.begin(), length, num);
+    FloatVectorOperations::add (dest, offset.begin(), num);
+    FloatVectorOperations::max (dest, dest, minimum.begin(), num);
+    FloatVectorOperations::min (dest, dest, maximum.begin(), num);
+    
+    // LayoutFrame truncates to int before adding the opposite side
+    for (int i = 0; i < num; ++i)
+        dest[i] = (float) (int) dest[i];
+    
+    if (opposite != nullptr)
+        FloatVectorOperations::addWithMultiply (dest, opposite, relative.begin(), num);
+}
+
+void LayoutFrameBatch::clear ()
+{
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+    numFrames = 0;
+}
+
+void LayoutFrameBatch::add (const LayoutFrame& frame)
+{
+    left.add (frame.left);
+    top.add (frame.top);
+    right.add (frame.right);
+    bottom.add (frame.bottom);
+    numFrames++;
+}
+
+void LayoutFrameBatch::resolve (const Rectangle<int>& parent, Array<Rectangle<int>>& results)
+{
+    if (allocated < numFrames)
+    {
+        allocated = numFrames;
+        x1.malloc (allocated);
+        y1.malloc (allocated);
+        x2.malloc (allocated);
+        y2.malloc (allocated);
+    }
+    
+    const float width  = (float) parent.getWidth();
+    const float height = (float) parent.getHeight();
+    
+    // Relative left and top sides refer to an opposite of 0, so they need no addition
+    left.resolve   (x1, width,  nullptr, numFrames);
+    top.resolve    (y1, height, nullptr, numFrames);
+    right.resolve  (x2, width,  x1, numFrames);
+    bottom.resolve (y2, height, y1, numFrames);
+    
+    // Prevent defunct rects
+    FloatVectorOperations::max (x2, x2, x1, numFrames);
+    FloatVectorOperations::max (y2, y2, y1, numFrames);
+    
+    results.clearQuick();
+    results.ensureStorageAllocated (numFrames);
+    
+    for (int i = 0; i < numFrames; ++i)
+        results.add (Rectangle<int> (Point<int> ((int) x1[i], (int) y1[i]),
+                                     Point<int> ((int) x2[i], (int) y2[i])));
+}
+
+String LayoutFrameBatch::runBenchmark (int iterations)
+{
+    String out;
+    Random random (42);
+    const Rectangle<int> parent (0, 0, 1280, 800);
+    
+    for (int count : { 10, 100, 1000 })
+    {
+        Array<LayoutFrame> frames;
+        for (int i = 0; i < count; ++i)
+        {
+            auto frame = LayoutFrame (random.nextFloat(), random.nextInt (20),
+                                      random.nextFloat(), random.nextInt (20),
+                                      0.0f, 40 + random.nextInt (100),
+                                      0.0f, 20);
+            frame.right.relative = true;
+            frame.bottom.relative = true;
+            frame.bottom.limits = Range<int> (0, 400);
+            frames.add (frame);
+        }
+        
+        LayoutFrameBatch batch;
+        for (auto& f : frames)
+            batch.add (f);
+        
+        Array<Rectangle<int>> results;
+        int checksum = 0;
+        
+        auto start = Time::getHighResolutionTicks();
+        for (int n = 0; n < iterations; ++n)
+        {
+            results.clearQuick();
+            for (auto& f : frames)
+                results.add (f.rectangleRelativeTo (parent));
+            checksum += results.getLast().getRight();
+        }
+        const double single = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        
+        // Verify both approaches agree
+        Array<Rectangle<int>> expected (results);
+        
+        start = Time::getHighResolutionTicks();
+        for (int n = 0; n < iterations; ++n)
+        {
+            batch.resolve (parent, results);
+            checksum += results.getLast().getRight();
+        }
+        const double batched = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        
+        jassert (expected == results);
+        
+        out << count << " frames: "
+            << String (single * 1.0e6 / iterations, 2) << " us individually, "
+            << String (batched * 1.0e6 / iterations, 2) << " us batched"
+            << (expected == results ? "" : " (MISMATCH!)")
+            << " [" << checksum << "]\n";
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,68 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "ans_LayoutFrame.h"
+
+namespace ans {
+    using namespace juce;
+
+/**
+ LayoutFrameBatch resolves many LayoutFrames against the same parent in one go. The frames are
+ kept as a struct of arrays, one per property of each side, so that each step of the calculation
+ is a single FloatVectorOperations call across all frames rather than a chain of branches per
+ frame. The results are identical to LayoutFrame::rectangleRelativeTo().
+ 
+ This pays off for composites with many children, e.g. grids built with LayoutCursor.
+ FramePositioner switches to it above a number of children.
+ */
+
+class LayoutFrameBatch
+{
+public:
+    LayoutFrameBatch () {}
+    
+    void clear ();
+    void add (const LayoutFrame& frame);
+    int size () const { return numFrames; }
+    
+    /** Resolve all frames relative to a parent rectangle. Only its size matters, like with LayoutFrame. */
+    void resolve (const Rectangle<int>& parent, Array<Rectangle<int>>& results);
+    
+    /**
+     Compare batched and individual resolution for 10, 100 and 1000 frames and return a summary.
+     Meant to be called from a debug menu or a console app, not at runtime.
+     */
+    static String runBenchmark (int iterations = 1000);
+    
+    /** Number of sibling frames from which FramePositioner uses a batch */
+    static constexpr int threshold = 16;
+    
+private:
+    
+    struct SideArrays
+    {
+        Array<float> fraction, offset, minimum, maximum, relative;
+        
+        void clear();
+        void add (const LayoutFrame::Side& side);
+        
+        /** Resolve into dest, given the parent length and the resolved opposite sides (or nullptr) */
+        void resolve (float* dest, float length, const float* opposite, int num) const;
+    };
+    
+    SideArrays left, top, right, bottom;
+    HeapBlock<float> x1, y1, x2, y2;
+    int numFrames = 0;
+    int allocated = 0;
+};
+
+}
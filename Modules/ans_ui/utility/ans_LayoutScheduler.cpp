@@ -0,0 +1,201 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_LayoutScheduler.h"
+#include "ans_Positioners.h"
+
+namespace ans {
+    using namespace juce;
+
+namespace
+{
+    int passDepth = 0;
+    uint32 positionerIds = 0;
+    
+    void invalidate (Component& comp)
+    {
+        if (auto positioner = dynamic_cast<UIPositioner*> (comp.getPositioner()))
+            positioner->invalidateLayout();
+    }
+}
+
+//==========================================================================================================
+#if 0
+#pragma mark LayoutScheduler
+#endif
+
+JUCE_IMPLEMENT_SINGLETON (LayoutScheduler)
+
+LayoutScheduler::LayoutScheduler ()
+{
+}
+
+LayoutScheduler::~LayoutScheduler ()
+{
+    cancelPendingUpdate();
+    clearSingletonInstance();
+}
+
+void LayoutScheduler::markDirty (Component& comp)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    
+    // Whatever the positioners remember is not to be trusted anymore. Ancestors mustn't
+    // skip their subtree either, in case they get laid out in the same pass.
+    for (auto c = &comp; c != nullptr; c = c->getParentComponent())
+        invalidate (*c);
+    
+    if (comp.getPositioner() == nullptr)
+        for (auto child : comp.getChildren())
+            invalidate (*child);
+    
+    for (auto& each : dirty)
+        if (each.getComponent() == &comp)
+            return;
+    
+    dirty.add (&comp);
+    triggerAsyncUpdate();
+}
+
+void LayoutScheduler::handleAsyncUpdate ()
+{
+    flush();
+}
+
+void LayoutScheduler::flush ()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    
+    cancelPendingUpdate();
+    
+    if (dirty.isEmpty())
+        return;
+    
+    // Components may be marked dirty again while laying out
+    auto pending = dirty;
+    dirty.clear();
+    
+    const bool outermost = passDepth == 0;
+    if (outermost)
+        callsInPass = 0;
+    
+    {
+        ScopedPass pass;
+        
+        HashMap<Component*, bool> pendingSet;
+        for (auto& each : pending)
+            if (auto comp = each.getComponent())
+                pendingSet.set (comp, true);
+        
+        for (auto& each : pending)
+        {
+            auto comp = each.getComponent();
+            if (comp == nullptr)
+                continue;
+            
+            // Covered by an ancestor that is laid out anyway?
+            bool covered = false;
+            for (auto p = comp->getParentComponent(); p != nullptr && ! covered; p = p->getParentComponent())
+                covered = pendingSet.contains (p);
+            
+            if (! covered)
+                layout (*comp);
+        }
+    }
+    
+    if (outermost)
+    {
+        stats.passes++;
+        stats.lastPassCalls = callsInPass;
+        stats.maxPassCalls = jmax (stats.maxPassCalls, callsInPass);
+    }
+}
+
+void LayoutScheduler::layout (Component& comp)
+{
+    auto parent = comp.getParentComponent();
+    
+    if (auto positioner = comp.getPositioner())
+    {
+        if (parent != nullptr)
+            positioner->applyNewBounds (parent->getBounds());
+        return;
+    }
+    
+    // Without a positioner of its own, the component's children still need laying out
+    for (auto child : comp.getChildren())
+        if (auto positioner = child->getPositioner())
+            positioner->applyNewBounds (comp.getBounds());
+}
+
+void LayoutScheduler::childrenChanged (Component& parent)
+{
+    if (auto host = dynamic_cast<AnchorSolver::Host*> (&parent))
+        if (auto solver = host->getAnchorSolver (false))
+            solver->invalidate();
+    
+    for (auto c = &parent; c != nullptr; c = c->getParentComponent())
+        invalidate (*c);
+}
+
+uint32 LayoutScheduler::nextPositionerId ()
+{
+    return ++positionerIds;
+}
+
+bool LayoutScheduler::isInsidePass ()
+{
+    return passDepth > 0;
+}
+
+void LayoutScheduler::countLayoutCall ()
+{
+    if (auto scheduler = getInstanceWithoutCreating())
+    {
+        scheduler->callsInPass++;
+        scheduler->stats.layoutCalls++;
+    }
+}
+
+void LayoutScheduler::countSkippedSubtree ()
+{
+    if (auto scheduler = getInstanceWithoutCreating())
+        scheduler->stats.skippedSubtrees++;
+}
+
+void LayoutScheduler::countMemoHit ()
+{
+    if (auto scheduler = getInstanceWithoutCreating())
+        scheduler->stats.memoHits++;
+}
+
+LayoutScheduler::ScopedPass::ScopedPass ()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    ++passDepth;
+}
+
+LayoutScheduler::ScopedPass::~ScopedPass ()
+{
+    --passDepth;
+}
+
+String LayoutScheduler::Statistics::toString () const
+{
+    String out;
+    out << "Layout passes: " << passes
+        << ", positioner calls: " << layoutCalls
+        << ", last pass: " << lastPassCalls
+        << ", max per pass: " << maxPassCalls
+        << ", settled subtrees skipped: " << skippedSubtrees
+        << ", memo hits: " << memoHits;
+    return out;
+}
+
+}
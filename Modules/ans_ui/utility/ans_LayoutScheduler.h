@@ -0,0 +1,102 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+ 
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+namespace ans {
+    using namespace juce;
+
+/**
+ LayoutScheduler collects components whose layout needs updating and resolves them in a single
+ top-down pass. Positioners already lay out their children recursively, but setBounds() also calls
+ resized() on every child, which would otherwise start laying out the same subtree all over again.
+ During a pass, UIComposite::resized() therefore leaves the work to the positioner that caused it.
+ 
+ Components marked dirty are laid out asynchronously, so that any number of resizes in the same
+ message callback results in one pass. Components that are descendants of other dirty components
+ are covered by their ancestor's layout and skipped.
+ */
+
+class LayoutScheduler :
+        public DeletedAtShutdown,
+        private AsyncUpdater
+{
+public:
+    
+    /** Counters to verify that each component is laid out once per pass */
+    struct Statistics
+    {
+        int passes = 0;             ///< Number of passes so far
+        int layoutCalls = 0;        ///< Positioner calls in total
+        int lastPassCalls = 0;      ///< Positioner calls in the most recent pass
+        int maxPassCalls = 0;       ///< Positioner calls in the busiest pass
+        int skippedSubtrees = 0;    ///< Positioner calls that found their subtree settled
+        int memoHits = 0;           ///< Child rectangles taken from a positioner's memo
+        
+        String toString() const;
+    };
+    
+    LayoutScheduler ();
+   ~LayoutScheduler ();
+    
+    /** Have a component and its descendants laid out in the next pass, even if their bounds didn't change */
+    void markDirty (Component& comp);
+    
+    /** Lay out all dirty components now, rather than waiting for the next pass */
+    void flush ();
+    
+    /** Whether a pass is currently running on the message thread */
+    static bool isInsidePass ();
+    
+    /** Called by positioners for the statistics */
+    static void countLayoutCall ();
+    static void countSkippedSubtree ();
+    static void countMemoHit ();
+    
+    /**
+     Positioners remember the bounds they applied last and skip their subtree if asked for the same
+     bounds again. When the children of a component change, or a positioner of a child is created or
+     deleted, this invalidates what the component and its ancestors remember, and has its AnchorSolver
+     collect the children again. Positioners elsewhere, e.g. in other rows of a UIVirtualForm, are
+     left alone.
+     */
+    static void childrenChanged (Component& parent);
+    
+    /**
+     Return a new id for a positioner, which is never reused. Positioners identify the children they
+     cached results for by these ids, since a new positioner may take the address of a deleted one.
+     */
+    static uint32 nextPositionerId ();
+    
+    const Statistics& getStatistics() const { return stats; }
+    
+    /** Marks a pass for its lifetime. Passes may nest, e.g. if a window is resized during a pass. */
+    struct ScopedPass
+    {
+        ScopedPass ();
+       ~ScopedPass ();
+        JUCE_DECLARE_NON_COPYABLE (ScopedPass)
+    };
+    
+    JUCE_DECLARE_SINGLETON (LayoutScheduler, true)
+    
+private:
+    void handleAsyncUpdate() override;
+    void layout (Component& comp);
+    
+    Array<Component::SafePointer<Component>> dirty;
+    Statistics stats;
+    int callsInPass = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE (LayoutScheduler)
+};
+
+}
@@ -11,10 +11,66 @@
 
 #include "JuceHeader.h"
 #include "ans_LayoutFrame.h"
+#include "ans_LayoutFrameBatch.h"
+#include "ans_AnchorSolver.h"
+#include "ans_UIArena.h"
+#include "ans_LayoutScheduler.h"
 
 namespace ans {
     using namespace juce;
 
+/**
+ UIPositioner is the common base of the framework's positioners. It remembers the bounds it applied
+ last, so that a subtree whose bounds are asked for again can be skipped entirely, e.g. when a window
+ is moved or a settled UI is laid out once more. What it remembers is invalidated by
+ LayoutScheduler::markDirty() and LayoutScheduler::childrenChanged() for the component and its ancestors.
+ */
+struct UIPositioner : Component::Positioner, UIArena::Allocated
+{
+    UIPositioner (Component& target) :
+        Component::Positioner (target),
+        id (LayoutScheduler::nextPositionerId())
+    {
+        if (auto parent = target.getParentComponent())
+            LayoutScheduler::childrenChanged (*parent);
+    }
+    
+    ~UIPositioner ()
+    {
+        // Only if a positioner is replaced, since a deleted component has left its parent already
+        if (auto parent = getComponent().getParentComponent())
+            LayoutScheduler::childrenChanged (*parent);
+    }
+    
+    /** Forget what was remembered, so the next call lays out the subtree again */
+    virtual void invalidateLayout() { settled = false; }
+    
+    /** Unique for the lifetime of the application (@see LayoutScheduler::nextPositionerId) */
+    uint32 getId() const { return id; }
+    
+protected:
+    
+    /** Whether the component got these bounds from us already and nothing changed since */
+    bool isSettled (const Rectangle<int>& bounds) const
+    {
+        return settled
+            && bounds == settledBounds
+            && getComponent().getBounds() == bounds;
+    }
+    
+    void markSettled (const Rectangle<int>& bounds)
+    {
+        settled = true;
+        settledBounds = bounds;
+    }
+    
+private:
+    const uint32 id;
+    Rectangle<int> settledBounds;
+    bool settled = false;
+};
+
+
 /**
  FramePositioner positions a Component according to a LayoutFrame that dynamically
  determines the component's bounds relative to it's parent's bounds.
@@ -22,99 +78,284 @@ namespace ans {
  components that don't need full FlexBox capabilities. It especially lends itself
  to layouts that get built incrementally (programmatically) with LayoutCursor.
  
+ The rectangles of frame-positioned children only depend on the size of the component, so they
+ are memoised for the last few sizes (see ANS_MEMOISE_LAYOUT). This helps with live resizing,
+ which tends to revisit the same sizes.
+ 
+ Frames anchored to siblings are resolved by the AnchorSolver of the parent, if it is an
+ AnchorSolver::Host. Once a parent has a solver, its other frame-positioned children go through
+ it as well, so that siblings anchored to them follow when they change.
+ 
  @see LayoutFrame, LayoutCursor
  */
-struct FramePositioner : Component::Positioner
+struct FramePositioner : UIPositioner
 {
     FramePositioner (Component &target,  const LayoutFrame& f) :
-        juce::Component::Positioner (target),
+        UIPositioner (target),
         frame (f)
     {
     }
     
     void applyNewBounds (const juce::Rectangle<int>& parentRect) override
     {
-        Rectangle<int> bounds = frame.rectangleRelativeTo (parentRect);
+        if (auto host = dynamic_cast<AnchorSolver::Host*> (getComponent().getParentComponent()))
+            if (auto solver = host->getAnchorSolver (frame.hasAnchors()))
+            {
+                solver->layout (*this, parentRect);
+                return;
+            }
+        
+        applyResolvedBounds (frame.rectangleRelativeTo (parentRect));
+    }
+    
+    /** Set the bounds that were resolved already, e.g. by a parent's LayoutFrameBatch, and lay out the children */
+    void applyResolvedBounds (const Rectangle<int>& bounds)
+    {
+        if (isSettled (bounds))
+        {
+            LayoutScheduler::countSkippedSubtree();
+            return;
+        }
+        
+        LayoutScheduler::countLayoutCall();
+        LayoutScheduler::ScopedPass pass;
+        
         getComponent().setBounds (bounds);
         
+        frames.clearQuick();
+        frameIds.clearQuick();
+        for (auto child : getComponent().getChildren())
+            if (auto positioner = dynamic_cast<FramePositioner*> (child->getPositioner()))
+                if (! positioner->frame.hasAnchors())
+                {
+                    frames.add (positioner);
+                    frameIds.add (positioner->getId());
+                }
+        
+        // Ids rather than addresses, since a new positioner may have taken the address of a deleted one
+        if (frameIds != batchedIds)
+        {
+            batched = frames;
+            batchedIds = frameIds;
+            batch.clear();
+            memo.clearQuick();
+            
+            if (frames.size() >= LayoutFrameBatch::threshold)
+                for (auto positioner : frames)
+                    batch.add (positioner->frame);
+        }
+        
+        const auto& rects = resolveChildren (bounds);
+        for (int i = 0; i < frames.size(); ++i)
+            frames.getUnchecked (i)->applyResolvedBounds (rects.getReference (i));
+        
+        // Anything else, including anchored frames
         for (auto child : getComponent().getChildren())
             if (auto positioner = child->getPositioner())
-                positioner->applyNewBounds (bounds);
+            {
+                auto framePositioner = dynamic_cast<FramePositioner*> (positioner);
+                if (framePositioner == nullptr || framePositioner->frame.hasAnchors())
+                    positioner->applyNewBounds (bounds);
+            }
+        
+        markSettled (bounds);
     }
     
     const LayoutFrame frame;
+    
+private:
+    
+    /** Rectangles of the batched children for one size */
+    struct Memo
+    {
+        Point<int> size;
+        Array<Rectangle<int>> rects;
+    };
+    
+    static constexpr int memoCapacity = ANS_MEMOISE_LAYOUT ? 4 : 0;
+    
+    /** Resolve the frames of all batched children, or take them from the memo */
+    const Array<Rectangle<int>>& resolveChildren (const Rectangle<int>& bounds)
+    {
+        const Point<int> size (bounds.getWidth(), bounds.getHeight());
+        
+        for (auto& each : memo)
+            if (each.size == size)
+            {
+                LayoutScheduler::countMemoHit();
+                return each.rects;
+            }
+        
+        if (batch.size() > 0)
+            batch.resolve (bounds, resolved);
+        else
+        {
+            // Few siblings resolve faster one by one
+            resolved.clearQuick();
+            for (auto positioner : batched)
+                resolved.add (positioner->frame.rectangleRelativeTo (bounds));
+        }
+        
+        if (memoCapacity == 0 || batched.isEmpty())
+            return resolved;
+        
+        // Replace the oldest entry once full
+        if (memo.size() >= memoCapacity)
+            memo.remove (0);
+        
+        memo.add ({ size, resolved });
+        return memo.getReference (memo.size() - 1).rects;
+    }
+    
+    LayoutFrameBatch batch;
+    Array<FramePositioner*> frames, batched;
+    Array<uint32> frameIds, batchedIds;
+    Array<Rectangle<int>> resolved;
+    Array<Memo> memo;
 };
     
+/**
+ Grid and FlexBox need an array of items that refer to the children. ItemCache collects the
+ positioners of the children and rebuilds the items only if they changed, so laying out a settled
+ container allocates nothing.
+ */
+template <class PositionerType, class ItemType>
+struct ItemCache
+{
+    /** Return true if the items were rebuilt */
+    bool update (Component& container, Array<ItemType>& items)
+    {
+        scratch.clearQuick();
+        scratchIds.clearQuick();
+        for (auto child : container.getChildren())
+            if (auto positioner = dynamic_cast<PositionerType*> (child->getPositioner()))
+            {
+                scratch.add (positioner);
+                scratchIds.add (positioner->getId());
+            }
+        
+        // Ids rather than addresses, since a new positioner may have taken the address of a deleted one
+        if (scratchIds == sourceIds)
+            return false;
+        
+        sources.swapWith (scratch);
+        sourceIds.swapWith (scratchIds);
+        
+        items.clearQuick();
+        for (auto positioner : sources)
+            items.add (positioner->getItem());
+        
+        return true;
+    }
+    
+    Array<PositionerType*> sources, scratch;
+    Array<uint32> sourceIds, scratchIds;
+};
+
 /**
  GridPositioner positions a Component according to a Grid, GridItem which dynamically
  determine the component's bounds relative to it's parent's bounds. The Grid setting
  applies, if the component is a container for children that each posess a GridItem setting.
+ Its own bounds are set by the parent's Grid, the parameter of applyNewBounds() is ignored.
  */
-struct GridPositioner : Component::Positioner
+struct GridPositioner : UIPositioner
 {
     GridPositioner (Component &target, const Grid &g, const GridItem &i) :
-        Component::Positioner(target),
+        UIPositioner (target),
         grid(g),
         gridItem(i)
     {
         gridItem.associatedComponent = &target;
     }
     
-    void applyNewBounds (const Rectangle<int> &area) override
+    void applyNewBounds (const Rectangle<int> &) override
     {
-        grid.items.clearQuick();
-        for (Component *child : getComponent().getChildren())
+        const auto bounds = getComponent().getBounds();
+        
+        if (isSettled (bounds))
         {
-            auto *positioner = dynamic_cast<GridPositioner*>(child->getPositioner());
-            if (positioner)
-                grid.items.add (positioner->gridItem);
+            LayoutScheduler::countSkippedSubtree();
+            return;
         }
         
-        grid.performLayout (getComponent().getBounds());
+        LayoutScheduler::countLayoutCall();
+        LayoutScheduler::ScopedPass pass;
+        
+        // Children are placed in our coordinate space
+        if (cache.update (getComponent(), grid.items) || bounds.getWidth() != lastSize.x || bounds.getHeight() != lastSize.y)
+        {
+            grid.performLayout (getComponent().getLocalBounds());
+            lastSize = { bounds.getWidth(), bounds.getHeight() };
+        }
         
         for (auto child : getComponent().getChildren())
             if (auto positioner = child->getPositioner())
-                positioner->applyNewBounds({});
+                positioner->applyNewBounds (bounds);
+        
+        markSettled (bounds);
     }
     
+    const GridItem& getItem() const { return gridItem; }
+    
     Grid     grid;
     GridItem gridItem;
+    
+private:
+    ItemCache<GridPositioner, GridItem> cache;
+    Point<int> lastSize { -1, -1 };
 };
 
 /**
  FlexPositioner positions a Component according to a FlexBox, FlexItem which dynamically
  determine the component's bounds relative to it's parent's bounds. The FlexBox setting
  applies, if the component is a container for children that each posess a FlexItem setting.
+ Its own bounds are set by the parent's FlexBox, the parameter of applyNewBounds() is ignored.
  */
-struct FlexPositioner : Component::Positioner
+struct FlexPositioner : UIPositioner
 {
     FlexPositioner (Component &target, const FlexBox &b, const FlexItem &i) :
-        Component::Positioner(target),
+        UIPositioner (target),
         flexBox(b),
         flexItem(i)
     {
         flexItem.associatedComponent = &target;
     }
     
-    void applyNewBounds (const Rectangle<int> &area) override
+    void applyNewBounds (const Rectangle<int> &) override
     {
-        flexBox.items.clearQuick();
-        for (Component *child : getComponent().getChildren())
+        const auto bounds = getComponent().getBounds();
+        
+        if (isSettled (bounds))
         {
-            auto *positioner = dynamic_cast<FlexPositioner*>(child->getPositioner());
-            if (positioner)
-                flexBox.items.add (positioner->flexItem);
+            LayoutScheduler::countSkippedSubtree();
+            return;
         }
         
-        flexBox.performLayout (getComponent().getBounds());
+        LayoutScheduler::countLayoutCall();
+        LayoutScheduler::ScopedPass pass;
+        
+        // Children are placed in our coordinate space
+        if (cache.update (getComponent(), flexBox.items) || bounds.getWidth() != lastSize.x || bounds.getHeight() != lastSize.y)
+        {
+            flexBox.performLayout (getComponent().getLocalBounds());
+            lastSize = { bounds.getWidth(), bounds.getHeight() };
+        }
         
         for (auto child : getComponent().getChildren())
             if (auto positioner = child->getPositioner())
-                positioner->applyNewBounds({});
+                positioner->applyNewBounds (bounds);
+        
+        markSettled (bounds);
     }
     
+    const FlexItem& getItem() const { return flexItem; }
+    
     FlexBox  flexBox;
     FlexItem flexItem;
+    
+private:
+    ItemCache<FlexPositioner, FlexItem> cache;
+    Point<int> lastSize { -1, -1 };
 };
 
 
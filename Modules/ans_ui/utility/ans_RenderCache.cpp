@@ -0,0 +1,164 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_RenderCache.h"
+
+namespace ans {
+    using namespace juce;
+
+//==========================================================================================================
+#if 0
+#pragma mark RenderCache
+#endif
+
+const StringArray RenderCache::PolicyNames = { "Never", "Always", "Auto" };
+
+RenderCache::RenderCache (Component& c, Statistics& s) :
+    owner (c),
+    stats (s)
+{
+}
+
+void RenderCache::paint (Graphics& g)
+{
+    // Same as Juce's own cache behind Component::setBufferedToImage(), plus counting
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto compBounds = owner.getLocalBounds();
+    const auto imageBounds = compBounds * scale;
+    
+    if (image.isNull() || image.getBounds() != imageBounds)
+    {
+        image = Image (owner.isOpaque() ? Image::RGB : Image::ARGB,
+                       jmax (1, imageBounds.getWidth()),
+                       jmax (1, imageBounds.getHeight()),
+                       ! owner.isOpaque());
+        validArea.clear();
+    }
+    
+    if (validArea.containsRectangle (compBounds))
+    {
+        stats.hits++;
+    }
+    else
+    {
+        stats.misses++;
+        
+        Graphics imageGraphics (image);
+        auto& context = imageGraphics.getInternalContext();
+        context.addTransform (AffineTransform::scale (scale));
+        
+        for (auto& valid : validArea)
+            context.excludeClipRectangle (valid);
+        
+        if (! owner.isOpaque())
+        {
+            context.setFill (Colours::transparentBlack);
+            context.fillRect (compBounds, true);
+            context.setFill (Colours::black);
+        }
+        
+        owner.paintEntireComponent (imageGraphics, true);
+    }
+    
+    validArea = compBounds;
+    
+    g.setColour (Colours::black.withAlpha (owner.getAlpha()));
+    g.drawImageTransformed (image, AffineTransform::scale ((float) compBounds.getWidth()  / imageBounds.getWidth(),
+                                                           (float) compBounds.getHeight() / imageBounds.getHeight()), false);
+}
+
+bool RenderCache::invalidateAll()
+{
+    validArea.clear();
+    return true;
+}
+
+bool RenderCache::invalidate (const Rectangle<int>& area)
+{
+    validArea.subtract (area);
+    return true;
+}
+
+void RenderCache::releaseResources()
+{
+    image = Image();
+}
+
+String RenderCache::Statistics::toString () const
+{
+    String out;
+    out << "Render cache hits: " << hits
+        << ", misses: " << misses
+        << ", switched on: " << enabled
+        << ", switched off: " << disabled;
+    return out;
+}
+
+//==========================================================================================================
+#if 0
+#pragma mark RenderCache::Monitor
+#endif
+
+JUCE_IMPLEMENT_SINGLETON (RenderCache::Monitor)
+
+RenderCache::Monitor::Monitor ()
+{
+}
+
+RenderCache::Monitor::~Monitor ()
+{
+    stopTimer();
+    clearSingletonInstance();
+}
+
+void RenderCache::Monitor::watch (Client* client)
+{
+    client->lastChange = frame;
+    
+    if (client->watched)
+        return;
+    
+    client->watched = true;
+    clients.add (client);
+    
+    if (! isTimerRunning())
+        startTimerHz (framesPerSecond);
+}
+
+void RenderCache::Monitor::unwatch (Client* client)
+{
+    if (! client->watched)
+        return;
+    
+    client->watched = false;
+    clients.removeFirstMatchingValue (client);
+}
+
+void RenderCache::Monitor::timerCallback ()
+{
+    ++frame;
+    
+    // Backwards, since clients are removed as they become idle
+    for (int i = clients.size(); --i >= 0;)
+    {
+        auto client = clients.getUnchecked (i);
+        
+        if (frame - client->lastChange >= (uint32) ANS_RENDER_CACHE_IDLE_FRAMES)
+        {
+            client->watched = false;
+            clients.remove (i);
+            client->renderCacheIdle();
+        }
+    }
+    
+    if (clients.isEmpty())
+        stopTimer();
+}
+
+}
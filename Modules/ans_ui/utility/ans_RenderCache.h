@@ -0,0 +1,118 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+namespace ans {
+    using namespace juce;
+
+/**
+ RenderCache keeps the rendering of a component in an image, just like Component::setBufferedToImage()
+ does, but it counts how often a paint could be served from the image (hits) and how often the image
+ had to be rendered again (misses). Components that hardly ever change, e.g. headers, legends or
+ group frames, then no longer repaint along with their parents.
+ 
+ Which components use a cache is decided per ComponentSpec (@see Policy). With Policy::Auto, UIAdaptor
+ switches the cache on once its bindings haven't performed for ANS_RENDER_CACHE_IDLE_FRAMES frames,
+ and off again as soon as one of them does.
+ */
+
+class RenderCache : public CachedComponentImage
+{
+public:
+    
+    enum class Policy
+    {
+        Never = 0,      ///< Paint as usual
+        Always,         ///< Keep a cache for the lifetime of the component
+        Auto            ///< Keep a cache while the component's bindings are idle
+    };
+    
+    /** Labels used for generating code and parsing input */
+    static const StringArray PolicyNames;
+    
+    /** Per component counters, kept by UIAdaptor while the cache comes and goes */
+    struct Statistics
+    {
+        int hits = 0;           ///< Paints served from the image
+        int misses = 0;         ///< Paints that had to render (part of) the image first
+        int enabled = 0;        ///< Number of times the cache was switched on
+        int disabled = 0;       ///< Number of times the cache was switched off
+        
+        String toString() const;
+    };
+    
+    RenderCache (Component& owner, Statistics& statistics);
+    
+    void paint (Graphics& g) override;
+    bool invalidateAll() override;
+    bool invalidate (const Rectangle<int>& area) override;
+    void releaseResources() override;
+    
+    //==========================================================================================================
+    
+    class Monitor;
+    
+    /** Anything whose cache is switched on by Monitor */
+    struct Client
+    {
+        virtual ~Client() {}
+        
+        /** Called by Monitor once the client has stayed unchanged long enough */
+        virtual void renderCacheIdle() = 0;
+        
+    private:
+        friend class Monitor;
+        uint32 lastChange = 0;
+        bool watched = false;
+    };
+    
+    /**
+     Monitor counts frames on a timer and tells clients when they haven't changed for the number of
+     frames given by ANS_RENDER_CACHE_IDLE_FRAMES. The timer only runs while there are clients to watch.
+     */
+    class Monitor :
+            public DeletedAtShutdown,
+            private Timer
+    {
+    public:
+        Monitor ();
+       ~Monitor ();
+        
+        /** The client just changed, so start counting its idle frames again */
+        void watch (Client* client);
+        
+        /** Stop watching a client, e.g. because it's deleted */
+        void unwatch (Client* client);
+        
+        static constexpr int framesPerSecond = 30;
+        
+        JUCE_DECLARE_SINGLETON (Monitor, false)
+        
+    private:
+        void timerCallback() override;
+        
+        Array<Client*> clients;
+        uint32 frame = 0;
+        
+        JUCE_DECLARE_NON_COPYABLE (Monitor)
+    };
+    
+private:
+    Component& owner;
+    Statistics& stats;
+    Image image;
+    RectangleList<int> validArea;
+    
+    JUCE_DECLARE_NON_COPYABLE (RenderCache)
+};
+
+}
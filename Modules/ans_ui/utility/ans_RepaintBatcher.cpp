@@ -0,0 +1,144 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_RepaintBatcher.h"
+
+namespace ans {
+    using namespace juce;
+
+//==========================================================================================================
+#if 0
+#pragma mark RepaintBatcher
+#endif
+
+JUCE_IMPLEMENT_SINGLETON (RepaintBatcher)
+
+RepaintBatcher::RepaintBatcher ()
+{
+}
+
+RepaintBatcher::~RepaintBatcher ()
+{
+    cancelPendingUpdate();
+    clearSingletonInstance();
+}
+
+void RepaintBatcher::add (Component& comp, const Rectangle<int>& area)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    
+    if (! ANS_BATCH_REPAINTS)
+    {
+        comp.repaint (area);
+        return;
+    }
+    
+    if (! comp.isShowing())
+        return;
+    
+    stats.requests++;
+    requestsInFrame++;
+    
+    // Map the area up to the top-level component, clipped by each parent like Component::repaint()
+    // does. Render caches along the way must learn about it, as they won't be asked for this area.
+    auto c = &comp;
+    auto r = area.getIntersection (comp.getLocalBounds());
+    
+    while (! r.isEmpty())
+    {
+        if (auto cache = c->getCachedComponentImage())
+            cache->invalidate (r);
+        
+        auto parent = c->getParentComponent();
+        if (parent == nullptr)
+            break;
+        
+        r = parent->getLocalArea (c, r).getIntersection (parent->getLocalBounds());
+        c = parent;
+    }
+    
+    if (r.isEmpty())
+        return;
+    
+    for (auto each : pending)
+        if (each->topLevel.getComponent() == c)
+        {
+            each->area.add (r);
+            return;
+        }
+    
+    auto entry = pending.add (new Pending());
+    entry->topLevel = c;
+    entry->area.add (r);
+    triggerAsyncUpdate();
+}
+
+void RepaintBatcher::handleAsyncUpdate ()
+{
+    flush();
+}
+
+void RepaintBatcher::flush ()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    
+    cancelPendingUpdate();
+    
+    if (pending.isEmpty())
+        return;
+    
+    // Repainting might request more, which goes into the next frame
+    OwnedArray<Pending> frame;
+    frame.swapWith (pending);
+    
+    int issued = 0;
+    int64 area = 0;
+    
+    for (auto each : frame)
+    {
+        auto topLevel = each->topLevel.getComponent();
+        if (topLevel == nullptr)
+            continue;
+        
+        auto& rects = each->area;
+        rects.consolidate();
+        
+        if (rects.getNumRectangles() > maxRectanglesPerFrame)
+            rects = RectangleList<int> (rects.getBounds());
+        
+        for (auto& r : rects)
+        {
+            topLevel->repaint (r);
+            area += (int64) r.getWidth() * r.getHeight();
+            issued++;
+        }
+    }
+    
+    stats.frames++;
+    stats.issued += issued;
+    stats.lastFrameRequests = requestsInFrame;
+    stats.lastFrameIssued = issued;
+    stats.lastFrameArea = area;
+    stats.maxFrameRequests = jmax (stats.maxFrameRequests, requestsInFrame);
+    requestsInFrame = 0;
+}
+
+String RepaintBatcher::Statistics::toString () const
+{
+    String out;
+    out << "Repaint frames: " << frames
+        << ", requests: " << requests
+        << ", rectangles repainted: " << issued
+        << ", last frame: " << lastFrameRequests << " -> " << lastFrameIssued
+        << " (" << lastFrameArea << " pixels)"
+        << ", max requests per frame: " << maxFrameRequests;
+    return out;
+}
+
+}
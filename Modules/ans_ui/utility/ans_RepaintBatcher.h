@@ -0,0 +1,86 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+namespace ans {
+    using namespace juce;
+
+/**
+ RepaintBatcher collects the areas that adaptors want repainted while the model broadcasts an update,
+ and repaints them once at the end of the message callback. Areas are merged per top-level component,
+ so a broadcast touching hundreds of labels results in a few rectangles being repainted, rather than
+ hundreds of individual calls to Component::repaint().
+ 
+ Adaptors request repaints through UIAdaptor::repaintComponent(). Repaints that Juce components issue
+ internally, e.g. Label::setText(), can't be intercepted and still go to their peer directly.
+ Define ANS_BATCH_REPAINTS as 0 to have every request repaint immediately, for comparison.
+ */
+
+class RepaintBatcher :
+        public DeletedAtShutdown,
+        private AsyncUpdater
+{
+public:
+    
+    /** Counters for judging how many repaints were merged */
+    struct Statistics
+    {
+        int frames = 0;                 ///< Flushes that had anything to repaint
+        int requests = 0;               ///< Repaints requested in total
+        int issued = 0;                 ///< Rectangles actually repainted in total
+        int lastFrameRequests = 0;      ///< Repaints requested for the most recent frame
+        int lastFrameIssued = 0;        ///< Rectangles repainted in the most recent frame
+        int64 lastFrameArea = 0;        ///< Pixels covered by the rectangles of the most recent frame
+        int maxFrameRequests = 0;       ///< Repaints requested for the busiest frame
+        
+        String toString() const;
+    };
+    
+    RepaintBatcher ();
+   ~RepaintBatcher ();
+    
+    /** Have an area of a component repainted at the end of the frame */
+    void add (Component& comp, const Rectangle<int>& area);
+    
+    /** Have an entire component repainted at the end of the frame */
+    void add (Component& comp) { add (comp, comp.getLocalBounds()); }
+    
+    /** Repaint everything collected so far now, rather than waiting for the end of the frame */
+    void flush ();
+    
+    /**
+     More rectangles than this per top-level component are merged into their bounding box, which is
+     usually cheaper to repaint than many small areas with lots of overhead each.
+     */
+    static constexpr int maxRectanglesPerFrame = 16;
+    
+    const Statistics& getStatistics() const { return stats; }
+    
+    JUCE_DECLARE_SINGLETON (RepaintBatcher, true)
+    
+private:
+    struct Pending
+    {
+        Component::SafePointer<Component> topLevel;
+        RectangleList<int> area;
+    };
+    
+    void handleAsyncUpdate() override;
+    
+    OwnedArray<Pending> pending;
+    int requestsInFrame = 0;
+    Statistics stats;
+    
+    JUCE_DECLARE_NON_COPYABLE (RepaintBatcher)
+};
+
+}
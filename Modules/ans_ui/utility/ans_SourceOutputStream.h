@@ -38,6 +38,15 @@ public:
         indent--;
         setNewLineString (nl());
     }
+    
+    /** Print a float so that it always reads as a float literal, e.g. 1.0f */
+    static String floatLiteral (float f)
+    {
+        String s (f, 6);
+        while (s.endsWithChar ('0') && ! s.endsWith (".0"))
+            s = s.dropLastCharacters (1);
+        return s + "f";
+    }
  
 private:
     
@@ -0,0 +1,172 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#include "ans_UIArena.h"
+
+namespace ans {
+    using namespace juce;
+
+namespace
+{
+    thread_local UIArena* currentArena = nullptr;
+    std::atomic<int> heapAllocations { 0 };
+}
+
+//==========================================================================================================
+#if 0
+#pragma mark UIArena
+#endif
+
+UIArena::UIArena (size_t chunkSizeInBytes) :
+    chunkSize (jmax ((size_t) 1024, chunkSizeInBytes))
+{
+}
+
+UIArena::~UIArena ()
+{
+    jassert (live == 0);
+}
+
+void UIArena::release (UIArena* arena)
+{
+    if (arena == nullptr)
+        return;
+
+    if (arena->live == 0)
+        delete arena;
+    else
+        arena->orphaned = true;
+}
+
+void UIArena::reset ()
+{
+    if (live == 0)
+        releaseChunks();
+    else
+        resetPending = true;
+}
+
+void* UIArena::allocate (size_t size, UIArena* arena)
+{
+    const size_t total = sizeof (Header) + ((size + 15) & ~(size_t) 15);
+    Header* header = nullptr;
+
+    if (arena != nullptr && total <= arena->chunkSize / 2)
+    {
+        header = static_cast<Header*> (arena->allocateFromChunks (total));
+        header->arena = arena;
+    }
+    else
+    {
+        header = static_cast<Header*> (::operator new (total));
+        header->arena = nullptr;
+        ++heapAllocations;
+    }
+    return header + 1;
+}
+
+void UIArena::deallocate (void* block)
+{
+    if (block == nullptr)
+        return;
+
+    auto header = static_cast<Header*> (block) - 1;
+
+    if (auto arena = header->arena)
+        arena->blockReturned();
+    else
+        ::operator delete (header);
+}
+
+void* UIArena::allocateFromChunks (size_t size)
+{
+    // Allocation happens on the message thread only, while building
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (chunks.isEmpty() || usedInChunk + size > chunkSize)
+    {
+        chunks.add (new HeapBlock<char> (chunkSize));
+        usedInChunk = 0;
+        stats.chunks++;
+    }
+
+    auto block = chunks.getLast()->get() + usedInChunk;
+    usedInChunk += size;
+
+    live++;
+    stats.allocations++;
+    stats.bytes += size;
+    return block;
+}
+
+void UIArena::blockReturned ()
+{
+    jassert (live > 0);
+    live--;
+    stats.skippedFrees++;
+
+    if (live > 0)
+        return;
+
+    if (orphaned)
+        delete this;
+    else if (resetPending)
+        releaseChunks();
+}
+
+void UIArena::releaseChunks ()
+{
+    jassert (live == 0);
+
+    if (! chunks.isEmpty())
+        stats.resets++;
+
+    chunks.clear();
+    usedInChunk = 0;
+    resetPending = false;
+}
+
+int UIArena::getNumHeapAllocations ()
+{
+    return heapAllocations.load();
+}
+
+UIArena* UIArena::getCurrent ()
+{
+    return currentArena;
+}
+
+String UIArena::Statistics::toString () const
+{
+    String out;
+    out << "UIArena{" << allocations << " allocations, "
+        << skippedFrees << " frees skipped, "
+        << chunks << " chunks, "
+        << resets << " resets, "
+        << (int) bytes << " bytes}";
+    return out;
+}
+
+//==========================================================================================================
+#if 0
+#pragma mark UIArena::Scope
+#endif
+
+UIArena::Scope::Scope (UIArena* arena) :
+    previous (currentArena)
+{
+    currentArena = arena;
+}
+
+UIArena::Scope::~Scope ()
+{
+    currentArena = previous;
+}
+
+}
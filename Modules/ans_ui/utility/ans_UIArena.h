@@ -0,0 +1,127 @@
+/**
+ Experimental UI Framework
+ -------------------------
+ Copyright 2019 me-ans@GitHub
+
+ This is incomplete work in progress and mainly for proof-of-concept, education
+ and discussion. Please regard the license terms accompanying this Juce module.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+namespace ans {
+    using namespace juce;
+
+/**
+ UIArena is a simple monotonic allocator for the many small objects the framework creates while
+ building a UI, e.g. bindings, positioners and the components with their adaptors. Blocks are handed out from large chunks and deleting
+ an object merely decrements a counter. The chunks are released all at once by reset(), typically
+ when UIInstance::clear() runs before the same UIModel gets populated again.
+
+ Every block carries a small header pointing back to its arena (or null for blocks that came from
+ the heap), so objects can be deleted the usual way, no matter where they were allocated. Since
+ Component and OwnedArray simply call delete, this requires no changes to ownership.
+
+ Classes opt in by deriving from UIArena::Allocated. Their operator new uses the arena of the
+ UIArena::Scope currently active on the calling thread, or the heap if there is none.
+ Objects created by std::make_shared (selection data, tab page lists, sort tasks) stay on the
+ heap, since they are shared beyond the build and sort tasks are released on other threads.
+ */
+
+class UIArena
+{
+public:
+
+    /** Counters for judging how many malloc/free calls were saved */
+    struct Statistics
+    {
+        int    allocations = 0;     ///< Blocks taken from the arena rather than the heap
+        int    skippedFrees = 0;    ///< Deletions that didn't call free()
+        int    chunks = 0;          ///< Chunks allocated from the heap
+        int    resets = 0;          ///< Number of times all chunks were released
+        size_t bytes = 0;           ///< Bytes handed out in total
+
+        String toString() const;
+    };
+
+    UIArena (size_t chunkSizeInBytes = 16384);
+
+    /**
+     Release all chunks. If some blocks are still in use, this is deferred until the last of
+     them is returned.
+     */
+    void reset();
+
+    /**
+     Dispose of an arena. It is deleted immediately if no blocks are in use, or else
+     as soon as the last one is returned. Never delete an arena directly!
+     */
+    static void release (UIArena* arena);
+
+    /** Return a block of memory from an arena, or from the heap if arena is nullptr */
+    static void* allocate (size_t size, UIArena* arena);
+
+    /** Return a block that was allocated by allocate(), no matter where it came from */
+    static void  deallocate (void* block);
+
+    /** Number of blocks currently in use */
+    int getNumLiveBlocks() const { return live; }
+
+    const Statistics& getStatistics() const { return stats; }
+
+    /** Number of blocks of Allocated classes that went to the heap, since there was no arena in scope */
+    static int getNumHeapAllocations();
+
+    /** Get the arena of the innermost Scope on the calling thread, if any */
+    static UIArena* getCurrent();
+
+    /** Makes an arena the current one on the calling thread for its lifetime */
+    struct Scope
+    {
+        Scope (UIArena* arena);
+       ~Scope ();
+
+        UIArena* previous;
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    /** Derive from this to have instances allocated from the current arena */
+    struct Allocated
+    {
+        static void* operator new (size_t size) { return UIArena::allocate (size, UIArena::getCurrent()); }
+        static void  operator delete (void* block) { UIArena::deallocate (block); }
+    };
+
+    /** Use with std::unique_ptr to have an owned arena released properly */
+    struct Releaser
+    {
+        void operator() (UIArena* arena) const { UIArena::release (arena); }
+    };
+
+private:
+   ~UIArena ();
+
+    /** Prepended to every block, padded to keep the block 16-byte aligned */
+    struct alignas(16) Header
+    {
+        UIArena* arena;
+    };
+
+    void* allocateFromChunks (size_t size);
+    void  blockReturned();
+    void  releaseChunks();
+
+    const size_t chunkSize;
+    OwnedArray<HeapBlock<char>> chunks;
+    size_t usedInChunk = 0;
+    int live = 0;
+    bool resetPending = false;
+    bool orphaned = false;
+    Statistics stats;
+
+    JUCE_DECLARE_NON_COPYABLE (UIArena)
+};
+
+}
@@ -21,19 +21,19 @@ WeakReference<UISpec> CustomExample::DefaultSpec = new UISpec
     auto part1 = new CompositeSpec ("part1");
     {
         auto l1 = new LabelSpec ("l1");
-        l1->setLayout (LayoutFrame("4", "4", "100% - 4", "40 relative"));
+        l1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -4), LayoutFrame::Side (0.0f, 40, {0, INT_MAX}, true)));
         l1->setLabel ("Canvas component populated with LayoutCursor");
         part1->addComponent (l1);
     }
     {
         auto swatches = new CanvasSpec ("swatches");
-        swatches->setLayout (LayoutFrame("4", "50", "100% - 200", "100% - 4"));
+        swatches->setLayout (LayoutFrame(0.0f, 4, 0.0f, 50, 1.0f, -200, 1.0f, -4));
         swatches->addBinding (Bind::Canvas (MEMBER (&CustomExample::populateCustomComponent), Canvases));
         part1->addComponent (swatches);
     }
     {
         auto user = new UserDefinedSpec ("user", "ColourSelector()", []() { return std::make_unique<ColourSelector>(); });
-        user->setLayout (LayoutFrame("100% - 200", "50", "100% - 4", "100% - 4"));
+        user->setLayout (LayoutFrame(1.0f, -200, 0.0f, 50, 1.0f, -4, 1.0f, -4));
         part1->addComponent (user);
     }
     return part1;
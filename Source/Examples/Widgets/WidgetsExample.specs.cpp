@@ -27,10 +27,10 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
     auto main = new CompositeSpec ("main");
     {
         auto part1 = new CompositeSpec ("part1");
-        part1->setLayout (LayoutFrame("4", "40", "100% - 300 [280..600]", "100% - 4 [200..600]"));
+        part1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 40), LayoutFrame::Side (1.0f, -300, {280, 600}, false), LayoutFrame::Side (1.0f, -4, {200, 600}, false)));
         {
             auto comments = new TextSpec ("comments", Transcript);
-            comments->setLayout (LayoutFrame("0", "0", "100%", "100% - 100"));
+            comments->setLayout (LayoutFrame(0.0f, 0, 0.0f, 0, 1.0f, 0, 1.0f, -100));
             comments->addBinding (Bind::GetValue (MEMBER (&WidgetsExample::getCommentsContents), Transcript));
             comments->addBinding (Bind::SetValue (MEMBER (&WidgetsExample::setCommentsContents)));
             comments->addBinding (Bind::GetEnabled (MEMBER (&WidgetsExample::getCommentsEnabled), Transcript));
@@ -40,7 +40,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto hideButton = new ButtonSpec ("hideButton");
-            hideButton->setLayout (LayoutFrame("0", "100% - 90", "33% - 2", "22 relative"));
+            hideButton->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 0), LayoutFrame::Side (1.0f, -90), LayoutFrame::Side (0.33f, -2), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
             hideButton->setLabel ("Disable");
             hideButton->addBinding (Bind::Action (MEMBER (&WidgetsExample::wasHideButtonClicked)));
             hideButton->addBinding (Bind::GetLabel (MEMBER (&WidgetsExample::getHideButtonLabel), Visibility));
@@ -48,7 +48,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto cancelButton = new ButtonSpec ("cancelButton");
-            cancelButton->setLayout (LayoutFrame("33%", "100% - 90", "66% - 2", "22 relative"));
+            cancelButton->setLayout (LayoutFrame(LayoutFrame::Side (0.33f, 0), LayoutFrame::Side (1.0f, -90), LayoutFrame::Side (0.66f, -2), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
             cancelButton->setLabel ("Cancel");
             cancelButton->addBinding (Bind::Action (MEMBER (&WidgetsExample::wasCancelButtonClicked)));
             cancelButton->addBinding (Bind::GetEnabled (MEMBER (&WidgetsExample::getCancelButtonEnabled), Visibility));
@@ -56,7 +56,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto okButton = new ButtonSpec ("okButton");
-            okButton->setLayout (LayoutFrame("66%", "100% - 90", "100%", "22 relative"));
+            okButton->setLayout (LayoutFrame(LayoutFrame::Side (0.66f, 0), LayoutFrame::Side (1.0f, -90), LayoutFrame::Side (1.0f, 0), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
             okButton->setLabel ("OK");
             okButton->addBinding (Bind::Action (MEMBER (&WidgetsExample::wasOkButtonClicked)));
             okButton->addBinding (Bind::GetEnabled (MEMBER (&WidgetsExample::getOkButtonEnabled), Visibility));
@@ -64,10 +64,10 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto group1 = new GroupSpec ("group1");
-            group1->setLayout (LayoutFrame("0", "100% - 60", "100%", "100%"));
+            group1->setLayout (LayoutFrame(0.0f, 0, 1.0f, -60, 1.0f, 0, 1.0f, 0));
             {
                 auto rad1 = new RadioSpec ("rad1", Settings);
-                rad1->setLayout (LayoutFrame("32", "20", "100 relative", "22 relative"));
+                rad1->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 32), LayoutFrame::Side (0.0f, 20), LayoutFrame::Side (0.0f, 100, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
                 rad1->setLabel ("A");
                 rad1->setGroup (1);
                 rad1->setValue (1);
@@ -78,7 +78,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
             }
             {
                 auto rad2 = new RadioSpec ("rad2");
-                rad2->setLayout (LayoutFrame("132", "20", "100 relative", "22 relative"));
+                rad2->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 132), LayoutFrame::Side (0.0f, 20), LayoutFrame::Side (0.0f, 100, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
                 rad2->setLabel ("B");
                 rad2->setGroup (1);
                 rad2->setValue (2);
@@ -87,7 +87,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
             }
             {
                 auto rad3 = new RadioSpec ("rad3");
-                rad3->setLayout (LayoutFrame("232", "20", "100 relative", "22 relative"));
+                rad3->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 232), LayoutFrame::Side (0.0f, 20), LayoutFrame::Side (0.0f, 100, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
                 rad3->setLabel ("C");
                 rad3->setGroup (1);
                 rad3->setValue (3);
@@ -100,17 +100,17 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
     }
     {
         auto part2 = new CompositeSpec ("part2");
-        part2->setLayout (LayoutFrame("100% - 300 [280..600]", "40", "100% - 4 [500..800]", "100% - 4 [200..600]"));
+        part2->setLayout (LayoutFrame(LayoutFrame::Side (1.0f, -300, {280, 600}, false), LayoutFrame::Side (0.0f, 40), LayoutFrame::Side (1.0f, -4, {500, 800}, false), LayoutFrame::Side (1.0f, -4, {200, 600}, false)));
         {
             auto progress = new ProgressSpec ("progress", Progress);
-            progress->setLayout (LayoutFrame("4", "4", "100% - 4", "22 relative"));
+            progress->setLayout (LayoutFrame(LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (0.0f, 4), LayoutFrame::Side (1.0f, -4), LayoutFrame::Side (0.0f, 22, {0, INT_MAX}, true)));
             progress->setLabel ("Press OK Button");
             progress->addBinding (Bind::GetValue (MEMBER (&WidgetsExample::getProgress), Progress));
             part2->addComponent (progress);
         }
         {
             auto list = new ListSpec ("list", Settings);
-            list->setLayout (LayoutFrame("4", "32", "100% - 4", "100% - 70"));
+            list->setLayout (LayoutFrame(0.0f, 4, 0.0f, 32, 1.0f, -4, 1.0f, -70));
             list->addBinding (Bind::GetValue (MEMBER (&WidgetsExample::getListContents), List));
             list->addBinding (Bind::GetSelection (MEMBER (&WidgetsExample::getListSelection), Settings));
             list->addBinding (Bind::SetSelection (MEMBER (&WidgetsExample::setListSelection)));
@@ -118,7 +118,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto combo = new ComboSpec ("combo", Settings);
-            combo->setLayout (LayoutFrame("4", "100% - 68", "100% - 4", "100% - 34"));
+            combo->setLayout (LayoutFrame(0.0f, 4, 1.0f, -68, 1.0f, -4, 1.0f, -34));
             combo->addBinding (Bind::GetValue (MEMBER (&WidgetsExample::getComboContents), Settings));
             combo->addBinding (Bind::SetValue (MEMBER (&WidgetsExample::setComboText)));
             combo->addBinding (Bind::GetSelection (MEMBER (&WidgetsExample::getComboSelection), Settings));
@@ -127,7 +127,7 @@ WeakReference<UISpec> WidgetsExample::DefaultSpec = new UISpec
         }
         {
             auto slider = new SliderSpec ("slider", Settings);
-            slider->setLayout (LayoutFrame("4", "100% - 32", "100% - 4", "100% - 4"));
+            slider->setLayout (LayoutFrame(0.0f, 4, 1.0f, -32, 1.0f, -4, 1.0f, -4));
             slider->setRange (0, 1, 0.1);
             slider->addBinding (Bind::GetValue (MEMBER (&WidgetsExample::getSlider), Settings));
             slider->addBinding (Bind::SetValue (MEMBER (&WidgetsExample::setSlider)));
@@ -21,6 +21,9 @@ public:
 
     void initialise (const String& commandLine) override
     {
+        // Build all specs in the background, starting with the one we're about to open
+        UISpecPrewarmer::getInstance()->start (MainModel::getMetaClass()->getDefaultSpec());
+        
         model.initialise (commandLine);
         model.open();
     }
@@ -45,14 +45,6 @@ public:
         return tabs;
     }
     
-    void postBuild (UIInstance& instance) override
-    {
-        if (instance.isForWindow())
-            changed (TabContents);
-        
-        Parent::postBuild (instance);
-    }
-    
 private:
     
     TabPageList::Shared tabs;
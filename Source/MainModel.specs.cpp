@@ -23,14 +23,14 @@ WeakReference<UISpec> MainModel::MainWindowSpec = new UISpec
  []()
  {
     auto window = new WindowSpec ();
-    window->setLayout (LayoutFrame("50% - 320", "50% - 300", "640 relative", "600 relative"));
+    window->setLayout (LayoutFrame(LayoutFrame::Side (0.5f, -320), LayoutFrame::Side (0.5f, -300), LayoutFrame::Side (0.0f, 640, {0, INT_MAX}, true), LayoutFrame::Side (0.0f, 600, {0, INT_MAX}, true)));
     window->setLabel ("Example Window");
     window->addBinding (Bind::GetLabel (MEMBER (&MainModel::getWindowTitle), Labels));
     {
         auto content = new CompositeSpec ("content");
         {
             auto tabComposite = new TabsSpec ("tabComposite");
-            tabComposite->setLayout (LayoutFrame("4", "4", "100% - 4", "100% - 4"));
+            tabComposite->setLayout (LayoutFrame(0.0f, 4, 0.0f, 4, 1.0f, -4, 1.0f, -4));
             tabComposite->setOrientation (TabbedButtonBar::Orientation::TabsAtTop);
             tabComposite->addBinding (Bind::GetValue (MEMBER (&MainModel::getTabPages), TabContents));
             tabComposite->addBinding (Bind::GetSelection (MEMBER (&MainModel::getTabSelection), TabSelection));